@@ -0,0 +1,720 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "game/basic_game.hpp"
+#include "game/env.hpp"
+#include "game/game.hpp"
+#include "game/game_batch.hpp"
+#include "game/multi_game.hpp"
+#include "graphics/renderer.hpp"
+#include "metrics/alloc_hooks.hpp"
+#include "scores/score_store.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * A game whose snake travels along a Hamiltonian cycle of the board.
+ *
+ * The snake is laid out on consecutive cycle Tiles and always moves onto the
+ * next one, so it can be ticked forever at any length without running into
+ * itself or the border. The cycle runs along the top row, snakes back and
+ * forth over the remaining rows leaving out the leftmost column and returns up
+ * that column, which requires an even number of playable rows. The game is
+ * driven through its public interface only, layouts are restored from a
+ * GameState.
+ */
+class SnakeGameBenchmark {
+   public:
+    /**
+     * @param[in] dim 2D screen dimensions of the game.
+     * @param[in] length Snake length, clamped to leave room to grow.
+     */
+    SnakeGameBenchmark(const ScreenDimension& dim, std::size_t length)
+        : game_(dim, 1, Rng(kSeed)) {
+        const int kTop = game_.GetBorder();
+        const int kBottom = dim.height - game_.GetBorder() - 1;
+        const int kLeft = game_.GetBorder();
+        const int kRight = dim.width - game_.GetBorder() - 1;
+
+        Tile tile = {.row = kTop, .col = kLeft, .direction = Direction::kUp};
+        cycle_.push_back(tile);
+        for (tile.col = kLeft + 1; tile.col <= kRight; ++tile.col) {
+            tile.direction = Direction::kRight;
+            cycle_.push_back(tile);
+        }
+        tile.col = kRight;
+        for (tile.row = kTop + 1; tile.row <= kBottom; ++tile.row) {
+            bool leftward = ((tile.row - kTop) % 2);
+            tile.direction = Direction::kDown;
+            cycle_.push_back(tile);
+            for (int i = 0; i < (kRight - kLeft - 1); ++i) {
+                tile.direction =
+                    leftward ? Direction::kLeft : Direction::kRight;
+                tile.col += leftward ? -1 : 1;
+                cycle_.push_back(tile);
+            }
+        }
+        tile.direction = Direction::kLeft;
+        tile.row = kBottom;
+        tile.col = kLeft;
+        cycle_.push_back(tile);
+        for (tile.row = kBottom - 1; tile.row > kTop; --tile.row) {
+            tile.direction = Direction::kUp;
+            cycle_.push_back(tile);
+        }
+
+        length_ = std::clamp<std::size_t>(length, 1, cycle_.size() - 2);
+        layout_.snake.reserve(length_);
+        Layout();
+    }
+
+    std::size_t Length() const { return length_; }
+    bool GameOver() const { return game_.GameOver(); }
+    const SnakeGame& GetGame() const { return game_; }
+
+    /** Return how far the snake may grow before it has to be shrunk. */
+    std::size_t MaxGrowth() const {
+        const std::size_t kMaxGrowth = 1024;
+        return std::min(kMaxGrowth, cycle_.size() - 1 - length_);
+    }
+
+    /**
+     * Lay the snake out on the first Length() cycle Tiles.
+     *
+     * The target is parked on the border where the snake never reaches it.
+     */
+    void Layout() {
+        head_ = length_ - 1;
+        Restore();
+    }
+
+    /** Cut the snake back down to Length() Tiles from its tail. */
+    void Shrink() { Restore(); }
+
+    /** Tick the game without eating. */
+    void Tick() { game_.Tick(Advance()); }
+
+    /** Tick the game with the target placed in front of the snake. */
+    void TickOntoTarget() {
+        (void)game_.PlaceTarget(cycle_[Next()]);
+        game_.Tick(Advance());
+    }
+
+    /** Tick the game and undo the tick again. */
+    void TickAndUndo() {
+        game_.Tick(Advance());
+        game_.Undo();
+        head_ = (head_ + cycle_.size() - 1) % cycle_.size();
+    }
+
+    void EnableUndo() { game_.EnableUndo(true); }
+    void Copy(SnakeGame& copy) const { copy = game_; }
+    void SaveState(GameState& state) const { game_.SaveState(state); }
+    void RestoreState(const GameState& state) { game_.RestoreState(state); }
+    bool SnakeWins() const { return game_.SnakeWins(); }
+    void Reset() { game_.Reset(); }
+    void Reset(std::uint64_t seed) { game_.Reset(seed); }
+
+   private:
+    static const std::uint64_t kSeed = 0x5eed;
+
+    std::size_t Next() const { return (head_ + 1) % cycle_.size(); }
+
+    /** Step the head along the cycle and return the direction it moves. */
+    Direction Advance() {
+        head_ = Next();
+        return cycle_[head_].direction;
+    }
+
+    /** Restore a snake of Length() cycle Tiles ending at the head. */
+    void Restore() {
+        layout_.snake.clear();
+        for (std::size_t i = 0; i < length_; ++i) {
+            layout_.snake.push_back(
+                cycle_[(head_ + cycle_.size() - i) % cycle_.size()]);
+        }
+        layout_.target = {.row = 0, .col = 0};
+        game_.RestoreState(layout_);
+    }
+
+    SnakeGame game_;
+    std::vector<Tile> cycle_; /**< Each Tile's direction is the move onto it. */
+    GameState layout_;        /**< State Restore() lays the snake out from. */
+    std::size_t length_ = 0;
+    std::size_t head_ = 0; /**< Position of the snake head within cycle_. */
+};
+
+}  // namespace game
+}  // namespace snake
+
+using snake::game::BasicSnakeGame;
+using snake::game::Direction;
+using snake::game::GameState;
+using snake::game::kNumFeatures;
+using snake::game::MultiSnakeGame;
+using snake::game::Observation;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+using snake::game::SnakeGameBatch;
+using snake::game::SnakeGameBenchmark;
+using snake::game::SnakeVecEnv;
+using snake::game::Tile;
+using snake::graphics::AnsiRenderer;
+using snake::graphics::NullRenderer;
+using snake::graphics::Renderer;
+using snake::scores::GameRecord;
+using snake::scores::ScoreStore;
+
+/**
+ * Counts the allocations made while a benchmark's timer is running and
+ * reports them as the allocs_per_iter counter.
+ *
+ * Benchmarks of the steady state of play, which must never allocate, pass
+ * kForbidden and fail with an error should anything they time allocate.
+ */
+class AllocationCounter {
+   public:
+    enum Policy { kAllowed, kForbidden };
+
+    explicit AllocationCounter(benchmark::State& state,
+                               Policy policy = kAllowed)
+        : state_(state),
+          policy_(policy),
+          start_(snake::metrics::GetNumAllocations()) {}
+
+    ~AllocationCounter() {
+        const std::uint64_t kAllocations =
+            snake::metrics::GetNumAllocations() - start_ - paused_;
+        state_.counters["allocs_per_iter"] =
+            benchmark::Counter(static_cast<double>(kAllocations),
+                               benchmark::Counter::kAvgIterations);
+        if ((kForbidden == policy_) && kAllocations) {
+            state_.SkipWithError("the steady state allocated");
+        }
+    }
+
+    void PauseTiming() {
+        state_.PauseTiming();
+        paused_at_ = snake::metrics::GetNumAllocations();
+    }
+
+    void ResumeTiming() {
+        paused_ += snake::metrics::GetNumAllocations() - paused_at_;
+        state_.ResumeTiming();
+    }
+
+   private:
+    benchmark::State& state_;
+    Policy policy_;
+    std::uint64_t start_;
+    std::uint64_t paused_ = 0;
+    std::uint64_t paused_at_ = 0;
+};
+
+/* arguments are the board width and height and the snake length as a
+ * percentage of the playable Tiles, where 0 stands for a length of one */
+static ScreenDimension Board(const benchmark::State& state) {
+    return {.width = static_cast<int>(state.range(0)),
+            .height = static_cast<int>(state.range(1))};
+}
+
+static std::size_t SnakeLength(const benchmark::State& state) {
+    const auto kPlayable =
+        static_cast<std::size_t>((state.range(0) - 2) * (state.range(1) - 2));
+    return kPlayable * static_cast<std::size_t>(state.range(2)) / 100;
+}
+
+static void BoardsAndLengths(benchmark::internal::Benchmark* bench) {
+    const int kBoards[][2] = {{80, 24}, {200, 60}, {500, 500}, {1000, 1000}};
+    const int kFills[] = {0, 25, 50, 75, 99};
+    bench->ArgNames({"width", "height", "fill"});
+    for (const auto& board : kBoards) {
+        for (int fill : kFills) {
+            bench->Args({board[0], board[1], fill});
+        }
+    }
+}
+
+static void Boards(benchmark::internal::Benchmark* bench) {
+    const int kBoards[][2] = {{80, 24}, {200, 60}, {500, 500}, {1000, 1000}};
+    bench->ArgNames({"width", "height", "fill"});
+    for (const auto& board : kBoards) {
+        bench->Args({board[0], board[1], 50});
+    }
+}
+
+static void BM_Tick(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    AllocationCounter allocations(state, AllocationCounter::kForbidden);
+    for (auto _ : state) {
+        game.Tick();
+    }
+    if (game.GameOver()) {
+        state.SkipWithError("the snake left the cycle");
+    }
+}
+BENCHMARK(BM_Tick)->Apply(BoardsAndLengths);
+
+static void BM_TickEat(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    AllocationCounter allocations(state, AllocationCounter::kForbidden);
+    std::size_t growth = 0;
+    for (auto _ : state) {
+        game.TickOntoTarget();
+        if (++growth == game.MaxGrowth()) {
+            allocations.PauseTiming();
+            game.Shrink();
+            growth = 0;
+            allocations.ResumeTiming();
+        }
+    }
+    if (game.GameOver()) {
+        state.SkipWithError("the snake left the cycle");
+    }
+}
+BENCHMARK(BM_TickEat)->Apply(BoardsAndLengths);
+
+static void BM_SnakeWins(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.SnakeWins());
+    }
+}
+BENCHMARK(BM_SnakeWins)->Apply(Boards);
+
+static void BM_TickUndo(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    game.EnableUndo();
+    game.TickAndUndo(); /* allocate the undo history */
+    AllocationCounter allocations(state, AllocationCounter::kForbidden);
+    for (auto _ : state) {
+        game.TickAndUndo();
+    }
+}
+BENCHMARK(BM_TickUndo)->Apply(BoardsAndLengths);
+
+/* a full copy costs in proportion to the board area, the compact state in
+ * proportion to the snake's length */
+static void BM_CopyGame(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    SnakeGame copy(Board(state));
+    game.Copy(copy);
+    AllocationCounter allocations(state);
+    for (auto _ : state) {
+        game.Copy(copy);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_CopyGame)->Apply(BoardsAndLengths);
+
+static void BM_SaveState(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    GameState saved;
+    game.SaveState(saved);
+    AllocationCounter allocations(state);
+    for (auto _ : state) {
+        game.SaveState(saved);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SaveState)->Apply(BoardsAndLengths);
+
+static void BM_RestoreState(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    GameState saved;
+    game.SaveState(saved);
+    AllocationCounter allocations(state);
+    for (auto _ : state) {
+        game.RestoreState(saved);
+    }
+}
+BENCHMARK(BM_RestoreState)->Apply(BoardsAndLengths);
+
+/* Reset() returns the previous snake's Tiles to the free set so its cost
+ * grows with the length of the snake being replaced */
+static void BM_Reset(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    AllocationCounter allocations(state);
+    for (auto _ : state) {
+        allocations.PauseTiming();
+        game.Layout();
+        allocations.ResumeTiming();
+        game.Reset();
+    }
+}
+BENCHMARK(BM_Reset)->Apply(BoardsAndLengths);
+
+static void BM_ResetSeed(benchmark::State& state) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    AllocationCounter allocations(state);
+    std::uint64_t seed = 0;
+    for (auto _ : state) {
+        game.Reset(seed++);
+    }
+}
+BENCHMARK(BM_ResetSeed)->Apply(Boards);
+
+/* constructing a game per game played, with the storage coming from the heap
+ * or from an arena that is reused for every game */
+static void BM_NewGame(benchmark::State& state) {
+    AllocationCounter allocations(state);
+    std::uint64_t seed = 0;
+    for (auto _ : state) {
+        SnakeGame game(Board(state), 1, Rng(seed++));
+        benchmark::DoNotOptimize(game.GetTargetTile());
+    }
+}
+BENCHMARK(BM_NewGame)->Apply(Boards);
+
+static void BM_NewGameArena(benchmark::State& state) {
+    /* without an upstream, the arena throws if GetStorageSize() falls short */
+    std::vector<std::byte> buffer(SnakeGame::GetStorageSize(Board(state), 1));
+    state.counters["bytes_per_game"] = static_cast<double>(buffer.size());
+    AllocationCounter allocations(state, AllocationCounter::kForbidden);
+    std::uint64_t seed = 0;
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource arena(
+            buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+        SnakeGame game(Board(state), 1, Rng(seed++), &arena);
+        benchmark::DoNotOptimize(game.GetTargetTile());
+    }
+}
+BENCHMARK(BM_NewGameArena)->Apply(Boards);
+
+/* both board variants play the same greedy games, see GreedyController, so
+ * any difference in time per tick comes from the board representation */
+template <typename Game>
+static Direction GreedyDirection(const Game& game) {
+    const Tile& head = game.GetSnake().front();
+    const Tile& target = game.GetTargetTile();
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    Direction best = head.direction;
+    int best_distance = 0;
+    bool found_safe = false;
+    for (const Direction& direction : kDirections) {
+        const Tile kNext = Neighbor(head, direction);
+        if (!game.IsFree(kNext)) {
+            continue;
+        }
+        const int kDistance = std::abs(kNext.row - target.row) +
+                              std::abs(kNext.col - target.col);
+        if (!found_safe || (kDistance < best_distance)) {
+            best = direction;
+            best_distance = kDistance;
+            found_safe = true;
+        }
+    }
+    return best;
+}
+
+template <typename Game>
+static void PlayGreedy(benchmark::State& state, Game& game) {
+    {
+        AllocationCounter allocations(state, AllocationCounter::kForbidden);
+        std::uint64_t seed = 0;
+        for (auto _ : state) {
+            if (game.GameOver()) {
+                game.Reset(++seed);
+            }
+            game.Tick(GreedyDirection(game));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_PlayDynamic(benchmark::State& state) {
+    SnakeGame game(Board(state), 1, Rng(0));
+    PlayGreedy(state, game);
+}
+BENCHMARK(BM_PlayDynamic)
+    ->ArgNames({"width", "height"})
+    ->Args({80, 24})
+    ->Args({200, 60});
+
+template <int Width, int Height>
+static void BM_PlayFixed(benchmark::State& state) {
+    /* the fixed game holds the whole board, keep it off the stack */
+    auto game = std::make_unique<BasicSnakeGame<Width, Height>>(Rng(0));
+    PlayGreedy(state, *game);
+}
+BENCHMARK_TEMPLATE(BM_PlayFixed, 80, 24);
+BENCHMARK_TEMPLATE(BM_PlayFixed, 200, 60);
+
+/* every snake greedily chases one of the targets, spreading the snakes over
+ * the targets by index */
+static void GreedyDirections(const MultiSnakeGame& game,
+                             std::vector<Direction>& directions) {
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    const std::vector<Tile>& targets = game.GetTargets();
+    for (std::size_t i = 0; i < game.GetNumSnakes(); ++i) {
+        if (!game.IsAlive(i) || targets.empty()) {
+            continue;
+        }
+        const Tile& head = game.GetSnake(i).front();
+        const Tile& target = targets[i % targets.size()];
+        directions[i] = head.direction;
+        int best_distance = 0;
+        bool found_safe = false;
+        for (const Direction& direction : kDirections) {
+            const Tile kNext = Neighbor(head, direction);
+            if (!game.IsFree(kNext)) {
+                continue;
+            }
+            const int kDistance = std::abs(kNext.row - target.row) +
+                                  std::abs(kNext.col - target.col);
+            if (!found_safe || (kDistance < best_distance)) {
+                directions[i] = direction;
+                best_distance = kDistance;
+                found_safe = true;
+            }
+        }
+    }
+}
+
+/* arguments are the board width and height and the number of snakes, there
+ * are a quarter as many targets as snakes */
+static void BM_MultiTick(benchmark::State& state) {
+    const auto kNumSnakes = static_cast<std::size_t>(state.range(2));
+    MultiSnakeGame game(Board(state), kNumSnakes,
+                        std::max<std::size_t>(1, kNumSnakes / 4), 1, Rng(0));
+    std::vector<Direction> directions(kNumSnakes, Direction::kNone);
+    std::int64_t moves = 0;
+    {
+        /* snakes outgrowing their storage allocate, resets do not */
+        AllocationCounter allocations(state);
+        std::uint64_t seed = 0;
+        for (auto _ : state) {
+            if (game.GetNumAlive() < kNumSnakes / 2) {
+                game.Reset(++seed);
+            }
+            GreedyDirections(game, directions);
+            moves += static_cast<std::int64_t>(game.GetNumAlive());
+            game.Tick(directions.data());
+        }
+    }
+    state.SetItemsProcessed(moves);
+}
+BENCHMARK(BM_MultiTick)
+    ->ArgNames({"width", "height", "snakes"})
+    ->Args({200, 60, 16})
+    ->Args({200, 60, 128})
+    ->Args({1000, 1000, 128})
+    ->Args({1000, 1000, 1024});
+
+/* the argument is the number of games, every snake circles a small square by
+ * turning clockwise every few ticks and keeping its direction, passed as
+ * Direction::kNone, in between */
+static void BM_BatchTick(benchmark::State& state) {
+    const auto kNumGames = static_cast<std::size_t>(state.range(0));
+    const int kSide = 8;
+    SnakeGameBatch batch({.width = 80, .height = 24}, kNumGames);
+    std::vector<Direction> straight(kNumGames, Direction::kNone);
+    std::vector<Direction> turns(kNumGames, Direction::kNone);
+    std::uint64_t seed = kNumGames;
+    std::int64_t tick = 0;
+    {
+        AllocationCounter allocations(state, AllocationCounter::kForbidden);
+        for (auto _ : state) {
+            if (0 != (++tick % kSide)) {
+                batch.Tick(straight.data());
+                continue;
+            }
+
+            /* long snakes eventually run into themselves, restart those
+             * games at the turns */
+            for (std::size_t i = 0; i < kNumGames; ++i) {
+                if (batch.GameOver(i)) {
+                    batch.Reset(i, ++seed);
+                }
+                switch (batch.GetSnakeTile(i, 0).direction) {
+                    case Direction::kUp:
+                        turns[i] = Direction::kRight;
+                        break;
+                    case Direction::kRight:
+                        turns[i] = Direction::kDown;
+                        break;
+                    case Direction::kDown:
+                        turns[i] = Direction::kLeft;
+                        break;
+                    default:
+                        turns[i] = Direction::kUp;
+                        break;
+                }
+            }
+            batch.Tick(turns.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(kNumGames));
+}
+BENCHMARK(BM_BatchTick)->ArgName("games")->Arg(64)->Arg(1024)->Arg(16384);
+
+/* arguments are the number of environments and the observation encoding,
+ * the agent follows the target directions of the head-relative features */
+static void BM_VecEnvStep(benchmark::State& state) {
+    const auto kNumEnvs = static_cast<std::size_t>(state.range(0));
+    const auto kObservation = static_cast<Observation>(state.range(1));
+    SnakeVecEnv env({.dim = {.width = 20, .height = 20}, .max_idle_ticks = 400},
+                    kNumEnvs);
+    std::vector<float> features(kNumEnvs * kNumFeatures);
+    std::vector<float> observations(kNumEnvs *
+                                    env.GetObservationSize(kObservation));
+    std::vector<Direction> actions(kNumEnvs, Direction::kNone);
+    std::vector<float> rewards(kNumEnvs);
+    std::vector<std::uint8_t> dones(kNumEnvs);
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    {
+        AllocationCounter allocations(state, AllocationCounter::kForbidden);
+        for (auto _ : state) {
+            env.Observe(Observation::kFeatures, features.data());
+            for (std::size_t i = 0; i < kNumEnvs; ++i) {
+                /* the last four features locate the target */
+                const float* kTargetDirection =
+                    &features[(i + 1) * kNumFeatures - 4];
+                for (std::size_t j = 0; j < 4; ++j) {
+                    if (kTargetDirection[j] > 0.0F) {
+                        actions[i] = kDirections[j];
+                    }
+                }
+            }
+            env.Step(actions.data(), rewards.data(), dones.data());
+            env.Observe(kObservation, observations.data());
+            benchmark::DoNotOptimize(observations.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(kNumEnvs));
+}
+BENCHMARK(BM_VecEnvStep)
+    ->ArgNames({"envs", "observation"})
+    ->ArgsProduct({{1, 64, 1024},
+                   {static_cast<int>(Observation::kGrid),
+                    static_cast<int>(Observation::kFeatures),
+                    static_cast<int>(Observation::kRays)}});
+
+/* draw a frame per tick, either just the Tiles the tick changed or, if full
+ * is set, the whole board */
+static void RenderTicks(benchmark::State& state, Renderer& renderer,
+                        bool full) {
+    SnakeGameBenchmark game(Board(state), SnakeLength(state));
+    renderer.DrawSnakeScreen(game.GetGame());
+
+    AllocationCounter allocations(state, AllocationCounter::kForbidden);
+    for (auto _ : state) {
+        game.Tick();
+        if (full) {
+            renderer.Invalidate();
+        }
+        renderer.DrawSnakeScreen(game.GetGame());
+    }
+}
+
+/* the ANSI renderer writes to /dev/null and reports the bytes per frame */
+static void RenderAnsi(benchmark::State& state, bool full) {
+    const int kFd = open("/dev/null", O_WRONLY);
+    {
+        AnsiRenderer renderer(kFd);
+        RenderTicks(state, renderer, full);
+        const std::uint64_t kBytes = renderer.GetBytesWritten();
+        state.counters["bytes_per_frame"] = benchmark::Counter(
+            static_cast<double>(kBytes), benchmark::Counter::kAvgIterations);
+    }
+    close(kFd);
+}
+
+static void BM_RenderAnsi(benchmark::State& state) { RenderAnsi(state, false); }
+BENCHMARK(BM_RenderAnsi)->Apply(Boards);
+
+static void BM_RenderAnsiFull(benchmark::State& state) {
+    RenderAnsi(state, true);
+}
+BENCHMARK(BM_RenderAnsiFull)->Apply(Boards);
+
+static void BM_RenderNull(benchmark::State& state) {
+    NullRenderer renderer;
+    RenderTicks(state, renderer, false);
+}
+BENCHMARK(BM_RenderNull)->Apply(Boards);
+
+/* the score benchmarks work on a fresh file in the temporary directory */
+class ScoreFile {
+   public:
+    ScoreFile() {
+        char path[] = "/tmp/snake_bench_scores_XXXXXX";
+        const int kFd = mkstemp(path);
+        if (kFd >= 0) {
+            close(kFd);
+            unlink(path);
+            path_ = path;
+        }
+    }
+    ~ScoreFile() {
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+    const std::string& GetPath() const { return path_; }
+
+   private:
+    std::string path_;
+};
+
+static void BM_ScoreAppend(benchmark::State& state) {
+    ScoreFile file;
+    ScoreStore store;
+    if (!store.Open(file.GetPath())) {
+        state.SkipWithError("unable to create the score file");
+        return;
+    }
+    GameRecord record;
+    {
+        AllocationCounter allocations(state, AllocationCounter::kForbidden);
+        for (auto _ : state) {
+            record.ticks++;
+            store.Append(record);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScoreAppend);
+
+/* the argument is the number of records the opened file holds */
+static void BM_ScoreOpen(benchmark::State& state) {
+    ScoreFile file;
+    {
+        ScoreStore store;
+        if (!store.Open(file.GetPath())) {
+            state.SkipWithError("unable to create the score file");
+            return;
+        }
+        GameRecord record;
+        for (std::int64_t i = 0; i < state.range(0); ++i) {
+            record.score = static_cast<int>(i % 1000);
+            store.Append(record);
+        }
+    }
+    for (auto _ : state) {
+        ScoreStore store;
+        store.Open(file.GetPath());
+        benchmark::DoNotOptimize(store.Size());
+    }
+}
+BENCHMARK(BM_ScoreOpen)->Arg(1000)->Arg(1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,255 @@
+#ifndef BASIC_GAME_HPP_
+#define BASIC_GAME_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "game/game.hpp"
+#include "game/packed_snake.hpp"
+#include "game/rng.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * SnakeGame on a board whose size is fixed at compile time.
+ *
+ * The rules, the order of the free Tiles and the use of the random number
+ * generator are the same as SnakeGame's, so a BasicSnakeGame and a SnakeGame
+ * of the same size built from equal generators and ticked in the same
+ * directions play out identically. SnakeGame remains the variant for boards
+ * sized at run time (e.g., the terminal) and the one the controllers, replays
+ * and renderer work with.
+ *
+ * Every bound is a constant and all state lives in std::arrays inside the
+ * object, so the game never touches the heap and the bounds checks of every
+ * tick fold into a single unsigned comparison per axis. The object's size
+ * grows with the board's area, so large boards are best kept off the stack.
+ * Undo and saved states are left to SnakeGame.
+ *
+ * @tparam Width Screen width including the border.
+ * @tparam Height Screen height including the border.
+ * @tparam Border Thickness of the border surrounding the playable Tiles.
+ */
+template <int Width, int Height, int Border = 1>
+class BasicSnakeGame {
+   public:
+    static_assert((Border >= 0) && (Width > 2 * Border) &&
+                      (Height > 2 * Border),
+                  "the board needs at least one playable Tile");
+    static_assert((Width <= kMaxPackedCoordinate) &&
+                      (Height <= kMaxPackedCoordinate),
+                  "the board is too large for packed Tiles");
+
+    static constexpr int kNumCells = Width * Height;
+    static constexpr int kNumPlayableCells =
+        (Width - 2 * Border) * (Height - 2 * Border);
+
+    using FixedSnake =
+        PackedSnake<static_cast<std::size_t>(kNumPlayableCells)>;
+
+    /**
+     * Spawn a snake and target using the parameter random number generator.
+     *
+     * @param[in] rng Generator used to place the snake and targets.
+     */
+    explicit BasicSnakeGame(const Rng& rng) : rng_(rng) {
+        ClearBoard();
+        Reset();
+    }
+
+    BasicSnakeGame() = delete;
+
+    int GetScore() const { return score_; }
+    static constexpr int GetBorder() { return Border; }
+    static constexpr ScreenDimension GetScreenDimension() {
+        return {.width = Width, .height = Height};
+    }
+    const Tile& GetTargetTile() const { return curr_target_; }
+    const FixedSnake& GetSnake() const { return snake_; }
+    bool GameOver() const { return game_over_; }
+    std::int64_t GetTicks() const { return ticks_; }
+    const TickDelta& GetLastDelta() const { return last_delta_; }
+
+    /** See SnakeGame::IsFree(). */
+    bool IsFree(const Tile& tile) const {
+        return (IsInBounds(tile) && !occupied_[CellIndex(tile)]);
+    }
+
+    /** Return true if the parameter Tile lies within the game border. */
+    static constexpr bool IsInBounds(const Tile& tile) {
+        /* negative offsets wrap around to large unsigned values */
+        return (static_cast<unsigned>(tile.row - Border) <
+                static_cast<unsigned>(Height - 2 * Border)) &&
+               (static_cast<unsigned>(tile.col - Border) <
+                static_cast<unsigned>(Width - 2 * Border));
+    }
+
+    /** Return true if the snake has won by populating every screen Tile. */
+    bool SnakeWins() const { return (0 == num_free_); }
+
+    /** See SnakeGame::Tick(). */
+    void Tick(const Direction& new_direction) {
+        if (game_over_) {
+            return;
+        }
+
+        MoveSnake((Direction::kNone == new_direction)
+                      ? snake_.front().direction
+                      : new_direction);
+        ticks_++;
+
+        const Tile& head = last_delta_.head;
+        if (!IsInBounds(head) || occupied_[CellIndex(head)]) {
+            game_over_ = true;
+            return;
+        }
+        OccupyCell(CellIndex(head));
+
+        if (head == curr_target_) {
+            score_ += kScoreIncrement;
+            ExtendSnake();
+            if (SnakeWins()) {
+                game_over_ = true;
+                return;
+            }
+
+            SpawnTarget();
+            last_delta_.target_moved = true;
+        }
+    }
+
+    /** Reset game state and spawn a new snake and target. */
+    void Reset() {
+        game_over_ = false;
+        score_ = 0;
+        ticks_ = 0;
+        last_delta_ = {};
+
+        /* a head which ended the game out of bounds or on top of the body
+         * was never marked */
+        for (const Tile& tile : snake_) {
+            if (IsInBounds(tile) && occupied_[CellIndex(tile)]) {
+                VacateCell(CellIndex(tile));
+            }
+        }
+        snake_.clear();
+
+        const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                         Direction::kLeft, Direction::kRight};
+        snake_.push_back({.row = Height / 2,
+                          .col = Width / 2,
+                          .direction = kDirections[rng_.Below(4)]});
+        OccupyCell(CellIndex(snake_.front()));
+
+        /* see SnakeGame::Reset() */
+        if (SnakeWins()) {
+            curr_target_ = {.row = snake_.front().row,
+                            .col = snake_.front().col,
+                            .direction = Direction::kNone};
+            game_over_ = true;
+            return;
+        }
+        SpawnTarget();
+    }
+
+    /** See SnakeGame::Reset(std::uint64_t). */
+    void Reset(std::uint64_t seed) {
+        rng_.Seed(seed);
+        ClearBoard();
+        Reset();
+    }
+
+   private:
+    static constexpr int kScoreIncrement = 10;
+    static constexpr int kNotFree = -1;
+
+    static constexpr int CellIndex(const Tile& tile) {
+        return tile.row * Width + tile.col;
+    }
+
+    void MoveSnake(const Direction& new_direction) {
+        const Tile kPrevHead = snake_.front();
+        const Tile kTail = snake_.back();
+        Tile head = Neighbor(kPrevHead, new_direction);
+        head.direction = new_direction;
+
+        last_delta_.prev_head = kPrevHead;
+        last_delta_.head = head;
+        last_delta_.vacated_tail = kTail;
+        last_delta_.tail_vacated = true;
+        last_delta_.target_moved = false;
+
+        VacateCell(CellIndex(kTail));
+        snake_.pop_back();
+        snake_.push_front(head);
+    }
+
+    void ExtendSnake() {
+        const Tile kTail = snake_.back();
+        const Tile kNewTail = Neighbor(kTail, Opposite(kTail.direction));
+        snake_.push_back(kNewTail);
+        last_delta_.tail_vacated = false;
+        OccupyCell(CellIndex(kNewTail));
+    }
+
+    void ClearBoard() {
+        occupied_.fill(false);
+        free_index_.fill(kNotFree);
+        num_free_ = 0;
+        for (int i = Border; i < (Height - Border); ++i) {
+            for (int j = Border; j < (Width - Border); ++j) {
+                const int kCell = CellIndex({.row = i, .col = j});
+                free_index_[kCell] = num_free_;
+                free_cells_[num_free_++] = kCell;
+            }
+        }
+        snake_.clear();
+    }
+
+    void SpawnTarget() {
+        const int kCell =
+            free_cells_[rng_.Below(static_cast<std::uint32_t>(num_free_))];
+        curr_target_ = {.row = kCell / Width,
+                        .col = kCell % Width,
+                        .direction = Direction::kNone};
+    }
+
+    void OccupyCell(int cell) {
+        /* swap the cell with the last free cell and drop it from the set */
+        const int kPos = free_index_[cell];
+        const int kLast = free_cells_[--num_free_];
+        free_cells_[kPos] = kLast;
+        free_index_[kLast] = kPos;
+        free_index_[cell] = kNotFree;
+        occupied_[cell] = true;
+    }
+
+    void VacateCell(int cell) {
+        free_index_[cell] = num_free_;
+        free_cells_[num_free_++] = cell;
+        occupied_[cell] = false;
+    }
+
+    bool game_over_ = false;
+    int score_ = 0;
+    std::int64_t ticks_ = 0;
+    TickDelta last_delta_;
+    FixedSnake snake_;
+    Tile curr_target_;
+    std::array<bool, kNumCells> occupied_; /**< Set if the snake covers the
+                                                Tile. */
+    std::array<int, kNumPlayableCells> free_cells_; /**< Unordered cells not
+                                                         covered by the
+                                                         snake. */
+    std::array<int, kNumCells> free_index_; /**< Position of each cell within
+                                                 free_cells_ or kNotFree. */
+    int num_free_ = 0;
+    Rng rng_;
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
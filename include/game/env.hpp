@@ -0,0 +1,197 @@
+#ifndef ENV_HPP_
+#define ENV_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/game_batch.hpp"
+#include "game/tile.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * Encodings of the game an agent observes, see EncodeObservation().
+ *
+ * Observations are written as flat arrays of floats into buffers owned by the
+ * caller, GetObservationSize() returns how many floats a buffer must hold.
+ */
+enum class Observation {
+    /**
+     * Dense occupancy grid of the playable Tiles with three channels in
+     * channel, row, column order: the snake's body without its head, the
+     * head and the target. A Tile holds 1 in the channels covering it and 0
+     * otherwise.
+     */
+    kGrid,
+    /**
+     * kNumFeatures features relative to the head: whether moving straight
+     * ahead, left or right ends the game, the direction the snake moves in
+     * one-hot encoded as up, down, left and right, and whether the target
+     * lies above, below, left or right of the head.
+     */
+    kFeatures,
+    /**
+     * Vision along kNumRays rays cast from the head, clockwise starting
+     * straight up. Each ray holds the inverse distance to the border, to the
+     * nearest body Tile or 0 if none, and 1 if the target lies on the ray.
+     */
+    kRays,
+};
+
+constexpr std::size_t kGridChannels = 3;
+constexpr std::size_t kNumFeatures = 11;
+constexpr std::size_t kNumRays = 8;
+constexpr std::size_t kRayValues = 3;
+
+/**
+ * Return the number of floats an observation of a game on the parameter
+ * board is made of.
+ */
+std::size_t GetObservationSize(Observation observation,
+                               const ScreenDimension& dim, int border);
+
+/**
+ * Write an observation of the game into the parameter buffer.
+ *
+ * The encoders touch the snake's Tiles and, for kGrid, every playable Tile
+ * but never allocate.
+ *
+ * @param[in] observation Encoding to write.
+ * @param[in] game Game to observe.
+ * @param[out] out Buffer of GetObservationSize() floats.
+ */
+void EncodeObservation(Observation observation, const SnakeGame& game,
+                       float* out);
+
+/** Write an observation of a single game of a batch, see above. */
+void EncodeObservation(Observation observation, const SnakeGameBatch& batch,
+                       std::size_t game, float* out);
+
+struct EnvConfig {
+    ScreenDimension dim; /**< Board size including the border. */
+    int border = 1;
+    float target_reward = 1.0F; /**< Reward for eating the target. */
+    float death_reward = -1.0F; /**< Reward for a move that ends the game
+                                     without winning it. */
+    float tick_reward = 0.0F;   /**< Reward added to every tick. */
+    std::int64_t max_idle_ticks = 0; /**< Ticks without eating after which
+                                          an episode is truncated, 0 for
+                                          none. */
+};
+
+/** Outcome of a single step of an environment. */
+struct StepResult {
+    float reward = 0.0F;
+    bool done = false;      /**< The episode has ended, either because the
+                                 game is over or because it was truncated. */
+    bool truncated = false; /**< The episode hit EnvConfig::max_idle_ticks. */
+};
+
+/**
+ * Gym style environment for training agents to play Snake.
+ *
+ * An episode is a single game. Actions are directions, Direction::kNone
+ * keeps the snake moving in its current direction. Episodes reset with the
+ * same seed and stepped with the same actions play out identically.
+ */
+class SnakeEnv {
+   public:
+    /** Allocate the game and Reset() it with seed 0. */
+    explicit SnakeEnv(const EnvConfig& config);
+
+    /** Start a new episode which depends only on the parameter seed. */
+    void Reset(std::uint64_t seed);
+
+    /**
+     * Advance the game one tick in the parameter direction.
+     *
+     * Stepping an episode which is done only returns done again.
+     */
+    StepResult Step(Direction action);
+
+    /** Write an observation of the game, see EncodeObservation(). */
+    void Observe(Observation observation, float* out) const {
+        EncodeObservation(observation, game_, out);
+    }
+
+    std::size_t GetObservationSize(Observation observation) const {
+        return snake::game::GetObservationSize(observation, config_.dim,
+                                               config_.border);
+    }
+
+    const EnvConfig& GetConfig() const { return config_; }
+    const SnakeGame& GetGame() const { return game_; }
+
+   private:
+    EnvConfig config_;
+    SnakeGame game_;
+    std::int64_t idle_ticks_ = 0; /**< Ticks since the target was last
+                                       eaten. */
+    bool done_ = false;
+};
+
+/**
+ * Many SnakeEnvs stepped at once for high sample throughput.
+ *
+ * The games are kept in a SnakeGameBatch, so a step advances every
+ * environment in a single vectorized pass, and results and observations are
+ * written into flat buffers holding one entry per environment. Finished
+ * episodes are reset automatically at the end of Step(), the observation
+ * that follows being the first of the next episode. Episode k of the
+ * environments, counting every episode started since Reset(seed) in the
+ * order they were started, is seeded with SplitMix64(seed + k) and plays out
+ * like a SnakeEnv reset with that seed. Stepping never allocates.
+ */
+class SnakeVecEnv {
+   public:
+    /** Allocate num_envs environments and Reset() them with seed 0. */
+    SnakeVecEnv(const EnvConfig& config, std::size_t num_envs);
+
+    std::size_t Size() const { return batch_.Size(); }
+
+    /** Start a new episode in every environment, see above. */
+    void Reset(std::uint64_t seed);
+
+    /**
+     * Advance every environment one tick.
+     *
+     * @param[in] actions Size() directions, one per environment.
+     * @param[out] rewards Size() rewards, see StepResult.
+     * @param[out] dones Size() flags set to 1 where the game ended, 2 where
+     *                   the episode was truncated and 0 otherwise.
+     */
+    void Step(const Direction* actions, float* rewards, std::uint8_t* dones);
+
+    /**
+     * Write an observation of every environment, that of environment i
+     * starting at out + i * GetObservationSize().
+     */
+    void Observe(Observation observation, float* out) const;
+
+    std::size_t GetObservationSize(Observation observation) const {
+        return snake::game::GetObservationSize(observation, config_.dim,
+                                               config_.border);
+    }
+
+    const EnvConfig& GetConfig() const { return config_; }
+    const SnakeGameBatch& GetBatch() const { return batch_; }
+
+   private:
+    /** Start the next episode in the parameter environment. */
+    void StartEpisode(std::size_t env);
+
+    EnvConfig config_;
+    SnakeGameBatch batch_;
+    std::uint64_t seed_ = 0;
+    std::uint64_t next_episode_ = 0;
+    std::vector<int> scores_;              /**< Scores before the step. */
+    std::vector<std::int64_t> idle_ticks_; /**< See SnakeEnv. */
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
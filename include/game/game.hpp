@@ -1,58 +1,92 @@
 #ifndef GAME_HPP_
 #define GAME_HPP_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
 #include <vector>
 
+#include "game/packed_snake.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+
 namespace snake {
 namespace game {
 
-enum class Direction {
-    kUp,
-    kDown,
-    kLeft,
-    kRight,
-    kNone,
-};
-
 struct ScreenDimension {
     int width = 0;
     int height = 0;
 };
 
+/* the snake head is the front of the buffer and the tail its back */
+using Snake = PackedSnake<>;
+
 /**
- * Representation of a single location on the screen.
+ * The Tiles changed by a single game tick.
  *
- * The screen is divided up into a grid of 2D coordinate locations called Tiles.
- * Tiles can optionally have a direction when they are associated with the
- * snake.
+ * Everything else on the board is exactly as it was before the tick, which
+ * lets a renderer redraw only these Tiles.
  */
-struct Tile {
-    int row = 0;
-    int col = 0;
-    Direction direction = Direction::kNone;
-
-    /* it's hacky but we exclude the direction in the equality comparison
-     * because we want to be able to compare snake tiles with target tiles which
-     * have no direction */
-    friend bool operator==(const Tile& a, const Tile& b) {
-        return ((a.row == b.row) && (a.col == b.col));
-    }
+struct TickDelta {
+    Tile head;                 /**< Tile the head moved onto. */
+    Tile prev_head;            /**< Tile the head left, now part of the body
+                                    unless the snake is a single Tile long. */
+    Tile vacated_tail;         /**< Tile the tail left. */
+    bool tail_vacated = false; /**< False if the snake grew into the Tile its
+                                    tail left. */
+    bool target_moved = false; /**< True if a new target was spawned. */
 };
 
-using Snake = std::vector<Tile>;
-using Targets = std::vector<Tile>;
+/**
+ * Compact copy of the state of a SnakeGame, see SnakeGame::SaveState().
+ *
+ * Unlike a copy of the SnakeGame itself, the size of a GameState depends on
+ * the length of the snake but not on the area of the board.
+ */
+struct GameState {
+    std::vector<Tile> snake; /**< Snake Tiles ordered from head to tail. */
+    Tile target;
+    TickDelta last_delta;
+    Rng rng;
+    int score = 0;
+    std::int64_t ticks = 0;
+    bool game_over = false;
+};
 
 class SnakeGame {
    public:
     /**
      * Spawn a snake and target on a screen with the parameter dimensions.
      *
-     * @param[in] dim 2D screen dimensions (i.e., height and width).
+     * The game's random number generator is seeded from std::random_device.
+     *
+     * @param[in] dim 2D screen dimensions (i.e., height and width), at most
+     *                kMaxPackedCoordinate each.
      * @param[in] border Thickness of the border surrounding the game window.
      *                   Currently, only a thickness of 1 is supported.
      */
     explicit SnakeGame(const ScreenDimension& dim, int border = 1);
 
+    /**
+     * Spawn a snake and target using the parameter random number generator.
+     *
+     * Two games constructed with equal generators and driven with the same
+     * sequence of directions play out identically. All of the game's storage
+     * is allocated from the parameter memory resource, which must outlive the
+     * game. Copies of the game allocate from the default resource instead.
+     *
+     * @param[in] dim 2D screen dimensions (i.e., height and width), at most
+     *                kMaxPackedCoordinate each.
+     * @param[in] border Thickness of the border surrounding the game window.
+     * @param[in] rng Generator used to place the snake and targets.
+     * @param[in] resource Memory resource for the board, snake and undo
+     *                     history.
+     */
+    SnakeGame(const ScreenDimension& dim, int border, const Rng& rng,
+              std::pmr::memory_resource* resource =
+                  std::pmr::get_default_resource());
+
     SnakeGame() = delete;
     ~SnakeGame() = default;
     SnakeGame(const SnakeGame&) = default;
@@ -60,28 +94,175 @@ class SnakeGame {
     SnakeGame(SnakeGame&&) = default;
     SnakeGame& operator=(SnakeGame&&) = default;
 
+    /**
+     * Return the number of bytes a game on the parameter board allocates
+     * when constructed, not counting the undo history.
+     *
+     * Useful for sizing an arena that holds one or more games.
+     */
+    static std::size_t GetStorageSize(const ScreenDimension& dim, int border);
+
     int GetScore() const { return score_; }
     int GetBorder() const { return border_; }
     ScreenDimension GetScreenDimension() const { return screen_dim_; }
-    const Tile& GetTargetTile() const { return targets_[curr_target_]; }
+    const Tile& GetTargetTile() const { return curr_target_; }
     const Snake& GetSnake() const { return snake_; }
     bool GameOver() const { return game_over_; }
 
+    /** Return the number of ticks played since the last Reset(). */
+    std::int64_t GetTicks() const { return ticks_; }
+
+    /**
+     * Return the Tiles changed by the most recent tick.
+     *
+     * The delta is only meaningful if GetTicks() is non-zero and describes
+     * the change from tick GetTicks() - 1 to tick GetTicks().
+     */
+    const TickDelta& GetLastDelta() const { return last_delta_; }
+
+    /**
+     * Return true if the snake could move onto the parameter Tile without
+     * ending the game.
+     *
+     * The check is conservative in that the current tail Tile is reported as
+     * blocked even though the tail would vacate it during the next tick.
+     */
+    bool IsFree(const Tile& tile) const {
+        return (IsInBounds(tile) && !occupied_[CellIndex(tile)]);
+    }
+
+    /** Return true if the parameter Tile lies within the game border. */
+    bool IsInBounds(const Tile& tile) const;
+
+    /** Return true if the snake has won by populating every screen Tile. */
+    bool SnakeWins() const;
+
     /**
      * Advance the snake one game tick in the parameter direction.
      *
      * If the game has ended, Tick() will do nothing.
      *
      * @param[in] new_direction Direction in which the snake shall move in this
-     * game tick.
+     * game tick, Direction::kNone keeps it moving in its current direction.
      */
     void Tick(const Direction& new_direction);
 
-    /** Reset game state and spawn a new snake and target. */
+    /**
+     * Reset game state and spawn a new snake and target.
+     *
+     * On a board of a single playable Tile there is no room for a target, the
+     * game is then won and over as soon as the snake spawns.
+     */
     void Reset();
 
+    /**
+     * Return the smallest screen the game could be resized to, see Resize().
+     *
+     * The snake must fit within the border and leave room for a target.
+     */
+    ScreenDimension GetMinScreenDimension() const;
+
+    /**
+     * Move the game onto a screen of different dimensions without ending it.
+     *
+     * The snake and target keep their Tiles if the snake lies within the new
+     * border. Otherwise both are shifted by the smallest offset which brings
+     * the whole snake inside and a target left outside the border or under
+     * the snake is spawned anew. The occupancy grid and free set are rebuilt
+     * in a single pass over the new screen, the snake's storage growing from
+     * the game's memory resource if the screen grew. Clears the undo history.
+     * GetLastDelta() no longer describes the screen afterwards, so renderers
+     * must redraw the whole board.
+     *
+     * @param[in] dim New 2D screen dimensions, at most kMaxPackedCoordinate
+     *                each.
+     * @returns false, leaving the game untouched, if the game has ended or
+     *          dim is smaller than GetMinScreenDimension().
+     */
+    bool Resize(const ScreenDimension& dim);
+
+    /**
+     * Reseed the game's random number generator and Reset() the game.
+     *
+     * Unlike Reset(), the game that follows depends only on the seed and the
+     * directions passed to Tick(), not on earlier games. This costs a pass
+     * over the board rather than over the previous snake.
+     */
+    void Reset(std::uint64_t seed);
+
+    /**
+     * Copy the game's state into the parameter GameState.
+     *
+     * Storage already held by the GameState is reused, so saving into the same
+     * GameState over and over does not allocate once it has held a snake of
+     * the current length.
+     */
+    void SaveState(GameState& state) const;
+
+    /**
+     * Restore a state saved from a game on a board of the same size.
+     *
+     * The restore touches only the Tiles of the current and the saved snake
+     * and does not allocate. The order in which the free Tiles are kept is
+     * not part of the saved state though, so targets spawned after the
+     * restore may differ from those of the game the state was saved from. Use
+     * Undo() to return to an earlier tick exactly. Clears the undo history.
+     */
+    void RestoreState(const GameState& state);
+
+    /**
+     * Start or stop recording the ticks played so they can be undone.
+     *
+     * Recording costs a little over a hundred bytes per tick. Disabling it,
+     * Reset() and RestoreState() clear the undo history.
+     */
+    void EnableUndo(bool enable);
+
+    /** Return the number of recorded ticks which can be undone. */
+    std::size_t GetUndoDepth() const { return undo_.size(); }
+
+    /**
+     * Undo the most recent ticks.
+     *
+     * The game is returned to exactly the state it was in before those ticks
+     * including the order of the free Tiles, so replaying the same directions
+     * afterwards spawns the same targets. Ticks played while the game was
+     * already over changed nothing and are not recorded.
+     *
+     * @param[in] num_ticks Number of ticks to undo, at most GetUndoDepth().
+     */
+    void Undo(std::size_t num_ticks = 1);
+
+    /** Forget the recorded ticks, e.g., once they can no longer be undone. */
+    void ClearUndoHistory() { undo_.clear(); }
+
+    /**
+     * Move the target onto the parameter free Tile.
+     *
+     * Play only ever spawns targets at random, this lets tests and benchmarks
+     * script where the snake eats. The move is not part of a tick, so a
+     * renderer drawing the game incrementally does not see it.
+     *
+     * @returns false and leaves the target in place if the game is over or
+     *          the Tile is not free.
+     */
+    bool PlaceTarget(const Tile& tile);
+
    private:
     static const int kScoreIncrement = 10;
+    static constexpr int kNotFree = -1;
+
+    /** Everything a single tick overwrites, see Undo(). */
+    struct TickUndo {
+        Tile tail;               /**< Tile popped off the tail. */
+        int head_pos = kNotFree; /**< Free set position of the new head. */
+        int grow_pos = kNotFree; /**< Free set position of the Tile the
+                                      snake grew into. */
+        Tile target;
+        TickDelta last_delta;
+        Rng rng;
+        int score = 0;
+    };
 
     /** Spawn a single snake head Tile with a random direction at the screen
      * center. */
@@ -90,8 +271,12 @@ class SnakeGame {
     /** Advance the snake one Tile in the parameter direction. */
     void MoveSnake(const Direction& new_direction);
 
-    /** Append a new snake Tile to the end of the snake. */
-    void ExtendSnake();
+    /**
+     * Append a new snake Tile to the end of the snake.
+     *
+     * @returns The position the new Tile held in the free set.
+     */
+    int ExtendSnake();
 
     /**
      * Return true if the game has ended in a loss.
@@ -104,16 +289,64 @@ class SnakeGame {
      */
     bool IsGameOver() const;
 
-    /** Return true if the snake has won by populating every screen Tile. */
-    bool SnakeWins() const;
+    /** Mark every playable Tile free and remove the snake. */
+    void ClearBoard();
+
+    /**
+     * Rebuild the free set in row major order from the occupancy grid.
+     *
+     * free_index_ must already hold kNotFree for every cell.
+     */
+    void ListFreeCells();
+
+    /** Return the top left and bottom right corners of the snake's bounding
+     * box. */
+    std::pair<Tile, Tile> GetSnakeBounds() const;
+
+    /** Place the target on a Tile chosen uniformly from the free Tiles. */
+    void SpawnTarget();
+
+    /**
+     * Mark the parameter cell as covered by the snake.
+     *
+     * @returns The position the cell held in the free set.
+     */
+    int OccupyCell(int cell);
+
+    /** Mark the parameter cell as no longer covered by the snake. */
+    void VacateCell(int cell);
+
+    /** Undo OccupyCell(), pos being the position it returned. */
+    void UnoccupyCell(int cell, int pos);
+
+    /** Undo VacateCell(), cell having been the last cell vacated. */
+    void UnvacateCell(int cell);
+
+    /** Vacate every cell of the snake and remove it. */
+    void RemoveSnake();
+
+    /** Return the index of the parameter Tile in the occupancy grid. */
+    int CellIndex(const Tile& tile) const {
+        return tile.row * screen_dim_.width + tile.col;
+    }
 
     bool game_over_;
     int score_;
+    std::int64_t ticks_;
+    TickDelta last_delta_;
     int border_;
     ScreenDimension screen_dim_;
     Snake snake_;
-    int curr_target_;
-    Targets targets_;
+    Tile curr_target_;
+    std::pmr::vector<bool> occupied_; /**< One bit per screen Tile, set if
+                                           the Tile is covered by the snake. */
+    std::pmr::vector<int> free_cells_; /**< Unordered cells of all playable
+                                            Tiles not covered by the snake. */
+    std::pmr::vector<int> free_index_; /**< Position of each screen cell within
+                                            free_cells_ or kNotFree. */
+    Rng rng_;
+    bool undo_enabled_ = false;
+    std::pmr::vector<TickUndo> undo_; /**< One entry per recorded tick. */
 };
 
 }  // namespace game
@@ -0,0 +1,134 @@
+#ifndef GAME_BATCH_HPP_
+#define GAME_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * Many independent games of Snake on equally sized boards stepped in lockstep.
+ *
+ * The per game state is stored as a structure of arrays: head rows, head
+ * columns, lengths, targets and game over flags each live in their own
+ * contiguous array indexed by game. Tick() first computes the next head
+ * position, bounds check and target hit for every game in a single branch
+ * free pass over those arrays which the compiler vectorizes, and only then
+ * updates the bodies, occupancy grids and free cell sets game by game.
+ *
+ * Game i of a batch reset with Reset(i, seed) plays out exactly like a
+ * SnakeGame reset with Reset(seed) given the same directions.
+ */
+class SnakeGameBatch {
+   public:
+    /**
+     * Allocate num_games games and reset game i with seed i.
+     *
+     * @param[in] dim 2D screen dimensions shared by every game, at most
+     *                kMaxPackedCoordinate each.
+     * @param[in] num_games Number of games in the batch.
+     * @param[in] border Thickness of the border surrounding each board.
+     */
+    SnakeGameBatch(const ScreenDimension& dim, std::size_t num_games,
+                   int border = 1);
+
+    std::size_t Size() const { return game_over_.size(); }
+    int GetBorder() const { return border_; }
+    ScreenDimension GetScreenDimension() const { return screen_dim_; }
+
+    bool GameOver(std::size_t game) const { return game_over_[game]; }
+    int GetScore(std::size_t game) const { return score_[game]; }
+    std::size_t GetLength(std::size_t game) const { return length_[game]; }
+    Tile GetTargetTile(std::size_t game) const {
+        return {.row = target_row_[game],
+                .col = target_col_[game],
+                .direction = Direction::kNone};
+    }
+
+    /** Return the i-th Tile of the game's snake counting from the head. */
+    Tile GetSnakeTile(std::size_t game, std::size_t i) const;
+
+    /** See SnakeGame::IsFree(). */
+    bool IsFree(std::size_t game, const Tile& tile) const;
+
+    /** See SnakeGame::SnakeWins(). */
+    bool SnakeWins(std::size_t game) const { return (0 == free_count_[game]); }
+
+    /** Reset a single game exactly like SnakeGame::Reset(seed). */
+    void Reset(std::size_t game, std::uint64_t seed);
+
+    /**
+     * Advance every game one tick, game i moving in directions[i].
+     *
+     * Games which have ended are left untouched.
+     *
+     * @param[in] directions Array of Size() directions, Direction::kNone
+     *                       keeps a snake moving in its current direction.
+     */
+    void Tick(const Direction* directions);
+
+   private:
+    static const int kScoreIncrement = 10;
+    static constexpr int kNotFree = -1;
+
+    int CellIndex(int row, int col) const {
+        return row * screen_dim_.width + col;
+    }
+
+    /* offsets of a game's slice within the flat per game buffers */
+    std::size_t BodyBase(std::size_t game) const { return game * capacity_; }
+    std::size_t CellBase(std::size_t game) const { return game * num_cells_; }
+
+    /** Return the index of the game's i-th body Tile within body buffers. */
+    std::size_t BodySlot(std::size_t game, std::size_t i) const;
+
+    void OccupyCell(std::size_t game, int cell);
+    void VacateCell(std::size_t game, int cell);
+    void SpawnTarget(std::size_t game);
+
+    /** Advance a game whose next head position was computed by Tick(). */
+    void FinishTick(std::size_t game, Direction direction);
+
+    int border_;
+    ScreenDimension screen_dim_;
+    std::size_t num_cells_; /**< Tiles on the screen including the border. */
+    std::size_t capacity_;  /**< Playable Tiles, i.e., the maximum length. */
+
+    /* hot per game state, one element per game */
+    std::vector<int> head_row_;
+    std::vector<int> head_col_;
+    std::vector<Direction> head_dir_;
+    std::vector<int> target_row_;
+    std::vector<int> target_col_;
+    std::vector<int> score_;
+    std::vector<std::size_t> length_;
+    std::vector<std::size_t> ring_head_; /**< Slot of the head in the body. */
+    std::vector<std::size_t> free_count_;
+    std::vector<std::uint8_t> game_over_;
+    std::vector<Rng> rng_;
+
+    /* results of the vectorized pass of Tick() */
+    std::vector<int> next_row_;
+    std::vector<int> next_col_;
+    std::vector<Direction> next_dir_;
+    std::vector<std::uint8_t> in_bounds_;
+    std::vector<std::uint8_t> hit_target_;
+
+    /* per game slices of capacity_ (body) or num_cells_ (grid) elements, the
+     * body directions packed two bits each, see GetPackedDirection() */
+    std::vector<int> body_cells_;
+    std::vector<std::uint8_t> body_dirs_;
+    std::vector<std::uint8_t> occupied_;
+    std::vector<int> free_cells_;
+    std::vector<int> free_index_;
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef INPUT_QUEUE_HPP_
+#define INPUT_QUEUE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * The producer only writes tail_ and the consumer only writes head_, each on
+ * its own cache line, so neither side ever waits on the other.
+ */
+template <typename T, std::size_t kCapacity>
+class SpscQueue {
+    static_assert((kCapacity > 0) && !(kCapacity & (kCapacity - 1)),
+                  "capacity must be a power of two");
+
+   public:
+    /** Append an element, returns false if the queue is full. */
+    bool Push(const T& value) {
+        const std::size_t kTail = tail_.load(std::memory_order_relaxed);
+        if ((kTail - head_.load(std::memory_order_acquire)) == kCapacity) {
+            return false;
+        }
+        slots_[kTail & (kCapacity - 1)] = value;
+        tail_.store(kTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Remove the oldest element, returns false if the queue is empty. */
+    bool Pop(T& value) {
+        const std::size_t kHead = head_.load(std::memory_order_relaxed);
+        if (kHead == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots_[kHead & (kCapacity - 1)];
+        head_.store(kHead + 1, std::memory_order_release);
+        return true;
+    }
+
+   private:
+    std::array<T, kCapacity> slots_ = {};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+/**
+ * Queue of the player's turns, consumed one per game tick.
+ *
+ * Turns are validated as they are pushed against the direction the snake will
+ * be heading once every queued turn has been applied: repeats of that
+ * direction and 180 degree reversals, which would run the snake into itself,
+ * are dropped. Push() and Pop() may be called from different threads.
+ */
+class InputQueue {
+   public:
+    /** @param[in] heading Direction the snake is currently heading. */
+    explicit InputQueue(Direction heading) : last_(heading) {}
+
+    /**
+     * Queue a turn, producer side.
+     *
+     * @returns false if the turn was invalid or the queue was full.
+     */
+    bool Push(Direction direction) {
+        if ((Direction::kNone == direction) || (last_ == direction) ||
+            (Opposite(last_) == direction)) {
+            return false;
+        }
+        if (!queue_.Push(direction)) {
+            return false;
+        }
+        last_ = direction;
+        return true;
+    }
+
+    /**
+     * Fetch the turn for the next tick, consumer side.
+     *
+     * @returns false if no turn is queued, the snake keeps its heading.
+     */
+    bool Pop(Direction& direction) { return queue_.Pop(direction); }
+
+   private:
+    /* enough for several turns within one tick at any game speed */
+    static const std::size_t kCapacity = 8;
+
+    SpscQueue<Direction, kCapacity> queue_;
+    Direction last_; /**< Heading after all queued turns, producer only. */
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
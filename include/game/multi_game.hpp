@@ -0,0 +1,189 @@
+#ifndef MULTI_GAME_HPP_
+#define MULTI_GAME_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * Many snakes and targets sharing a single board.
+ *
+ * Every Tile of the board records which snake, if any, covers it, so moving a
+ * snake and checking it for collisions touches only its head and tail and a
+ * tick costs O(number of snakes) however long the snakes grow. Targets are
+ * spawned uniformly on Tiles covered by neither a snake nor another target.
+ *
+ * All living snakes move at once and a tick is resolved in these steps:
+ *   (1) Every snake whose new head lands on a target keeps its tail, every
+ *       other snake's tail leaves its Tile.
+ *   (2) A snake dies if its new head leaves the board, lands on a Tile still
+ *       covered by any snake (its own body included) or lands on the same
+ *       Tile as another snake's new head.
+ *   (3) Every surviving snake which reached a target eats it and grows.
+ *   (4) The bodies of the snakes that died are cleared from the board and
+ *       eaten targets are replaced.
+ * Since tails leave before heads arrive, a head may move onto the Tile of a
+ * tail which moves on, and two 1-tile snakes moving onto each other's Tile
+ * pass through each other and both survive.
+ * Which snakes survive and grow does not depend on the order of the snakes.
+ * Only where new targets spawn does, through the order in which the free
+ * Tiles are kept, which is why snakes are always processed by index.
+ */
+class MultiSnakeGame {
+   public:
+    static constexpr int kNoSnake = -1;
+
+    /**
+     * Spawn the snakes and targets at random free Tiles.
+     *
+     * Each snake starts out one Tile long heading in a random direction.
+     * Snakes and targets are placed for as long as free Tiles remain.
+     *
+     * @param[in] dim 2D screen dimensions (i.e., height and width), at most
+     *                kMaxPackedCoordinate each.
+     * @param[in] num_snakes Number of snakes on the board.
+     * @param[in] num_targets Number of targets kept on the board.
+     * @param[in] border Thickness of the border surrounding the board.
+     * @param[in] rng Generator used to place the snakes and targets.
+     */
+    MultiSnakeGame(const ScreenDimension& dim, std::size_t num_snakes,
+                   std::size_t num_targets, int border, const Rng& rng);
+
+    int GetBorder() const { return border_; }
+    ScreenDimension GetScreenDimension() const { return screen_dim_; }
+    std::int64_t GetTicks() const { return ticks_; }
+
+    std::size_t GetNumSnakes() const { return snakes_.size(); }
+    std::size_t GetNumAlive() const { return num_alive_; }
+
+    /** Return true once every snake has died. */
+    bool GameOver() const { return (0 == num_alive_); }
+
+    bool IsAlive(std::size_t snake) const { return alive_[snake]; }
+    int GetScore(std::size_t snake) const { return score_[snake]; }
+
+    /** Return the Tiles of the snake from head to tail, empty once dead. */
+    const Snake& GetSnake(std::size_t snake) const { return snakes_[snake]; }
+
+    /** Return the Tiles of the targets currently on the board. */
+    const std::vector<Tile>& GetTargets() const { return targets_; }
+
+    /** Return the snake covering the parameter Tile or kNoSnake. */
+    int GetOwner(const Tile& tile) const {
+        return IsInBounds(tile) ? owner_[CellIndex(tile)] : kNoSnake;
+    }
+
+    /** Return true if the parameter Tile lies within the game border. */
+    bool IsInBounds(const Tile& tile) const {
+        return (tile.row >= border_) &&
+               (tile.row < (screen_dim_.height - border_)) &&
+               (tile.col >= border_) &&
+               (tile.col < (screen_dim_.width - border_));
+    }
+
+    /**
+     * Return true if no snake covers the parameter Tile.
+     *
+     * Like SnakeGame::IsFree(), tails are reported as blocked even though
+     * they leave their Tile during the next tick unless their snake eats.
+     */
+    bool IsFree(const Tile& tile) const {
+        return (IsInBounds(tile) && (kNoSnake == owner_[CellIndex(tile)]));
+    }
+
+    /**
+     * Advance every living snake one Tile, snake i moving in directions[i].
+     *
+     * Does nothing once GameOver() returns true.
+     *
+     * @param[in] directions Array of GetNumSnakes() directions, entries of
+     *                       dead snakes are ignored and Direction::kNone
+     *                       keeps a snake moving in its current direction.
+     */
+    void Tick(const Direction* directions);
+
+    /** Clear the board and spawn new snakes and targets. */
+    void Reset();
+
+    /** Reseed the random number generator and Reset() the game. */
+    void Reset(std::uint64_t seed);
+
+   private:
+    static const int kScoreIncrement = 10;
+    static constexpr int kNotFree = -1;
+    static constexpr int kNoTarget = -1;
+    static constexpr std::size_t kInitialCapacity = 16;
+
+    int CellIndex(const Tile& tile) const {
+        return tile.row * screen_dim_.width + tile.col;
+    }
+
+    /** Remove the parameter cell from the free set. */
+    void TakeCell(int cell);
+
+    /** Return the parameter cell to the free set. */
+    void FreeCell(int cell);
+
+    /** Remove a random cell from the free set and return it. */
+    int TakeRandomCell();
+
+    /** Add the Tile as the head of the parameter snake. */
+    void PushHead(std::size_t snake, const Tile& head);
+
+    /** Kill the parameter snake and clear its body from the board. */
+    void RemoveSnake(std::size_t snake);
+
+    /** Place a target on a random free Tile, if there is one. */
+    void SpawnTarget();
+
+    /** Remove the target on the parameter cell from the board. */
+    void RemoveTarget(int cell);
+
+    int border_;
+    ScreenDimension screen_dim_;
+    std::size_t num_targets_;
+    std::int64_t ticks_ = 0;
+    std::size_t num_alive_ = 0;
+    Rng rng_;
+
+    /* per snake state */
+    std::vector<Snake> snakes_;
+    std::vector<std::uint8_t> alive_;
+    std::vector<int> score_;
+
+    /* per tick scratch space, one entry per snake */
+    std::vector<Tile> next_head_;
+    std::vector<std::uint8_t> eats_;
+    std::vector<std::uint8_t> dies_;
+
+    /* stamps claims_ entries, unlike ticks_ it is never reset */
+    std::uint64_t claim_stamp_ = 0;
+
+    std::vector<Tile> targets_;
+
+    /* one entry per screen Tile */
+    std::vector<int> owner_;        /**< Snake covering the Tile or
+                                         kNoSnake. */
+    std::vector<int> target_index_; /**< Position within targets_ of the
+                                         target on the Tile or kNoTarget. */
+    std::vector<int> free_index_;   /**< Position within free_cells_ or
+                                         kNotFree. */
+    std::vector<std::uint64_t> claims_; /**< Stamp of the last tick a head
+                                             moved onto the Tile, shifted
+                                             left by one, with the lowest
+                                             bit set if several did. */
+
+    /** Unordered cells covered by neither a snake nor a target. */
+    std::vector<int> free_cells_;
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef PACKED_SNAKE_HPP_
+#define PACKED_SNAKE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "game/ring_buffer.hpp"
+#include "game/tile.hpp"
+
+namespace snake {
+namespace game {
+
+/**
+ * Fixed capacity double ended queue of snake Tiles stored in packed form.
+ *
+ * Behaves like a RingBuffer<Tile> except that elements are returned by
+ * value: each Tile is kept as a PackedTile plus two bits of direction in a
+ * separate stream, 4.25 bytes rather than the 12 of a Tile. Pushed Tiles
+ * must head in one of the four directions of movement and lie within
+ * kMaxPackedCoordinate of the origin. Capacity works as for RingBuffer.
+ */
+template <std::size_t Capacity = kDynamicCapacity>
+class PackedSnake {
+   public:
+    class ConstIterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Tile;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Tile;
+
+        ConstIterator() = default;
+        ConstIterator(const PackedSnake* snake, std::size_t index)
+            : snake_(snake), index_(index) {}
+
+        Tile operator*() const { return (*snake_)[index_]; }
+
+        ConstIterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        ConstIterator operator++(int) {
+            ConstIterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+            return (a.index_ == b.index_);
+        }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        const PackedSnake* snake_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    using value_type = Tile;
+    using const_iterator = ConstIterator;
+
+    PackedSnake() = default;
+    explicit PackedSnake(std::size_t capacity) { Reset(capacity); }
+
+    /** Construct an empty dynamic snake allocating from resource. */
+    explicit PackedSnake(std::pmr::memory_resource* resource)
+        : cells_(resource), directions_(resource) {}
+
+    /**
+     * Return the number of bytes a dynamic snake of the parameter capacity
+     * allocates.
+     */
+    static constexpr std::size_t GetStorageSize(std::size_t capacity) {
+        return capacity * sizeof(PackedTile) +
+               GetPackedDirectionBytes(capacity);
+    }
+
+    /** Remove all Tiles and set the capacity of a dynamic snake. */
+    void Reset(std::size_t capacity) {
+        static_assert(kDynamicCapacity == Capacity,
+                      "the capacity of the snake is fixed");
+        cells_.resize(capacity);
+        directions_.resize(GetPackedDirectionBytes(capacity));
+        clear();
+    }
+
+    /**
+     * Raise the capacity of a dynamic snake to at least the parameter
+     * capacity, keeping its Tiles.
+     */
+    void Grow(std::size_t capacity) {
+        static_assert(kDynamicCapacity == Capacity,
+                      "the capacity of the snake is fixed");
+        if (capacity <= cells_.size()) {
+            return;
+        }
+        PackedSnake grown(cells_.get_allocator().resource());
+        grown.Reset(capacity);
+        for (std::size_t i = 0; i < size_; ++i) {
+            grown.push_back((*this)[i]);
+        }
+        *this = std::move(grown);
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return cells_.size(); }
+    bool empty() const { return (0 == size_); }
+    bool full() const { return (cells_.size() == size_); }
+
+    /** Return the i-th Tile counting from the front of the snake. */
+    Tile operator[](std::size_t i) const {
+        const std::size_t kSlot = Wrap(head_ + i);
+        return UnpackTile(cells_[kSlot], GetDirection(kSlot));
+    }
+
+    Tile front() const { return (*this)[0]; }
+    Tile back() const { return (*this)[size_ - 1]; }
+
+    /** Change the direction of the i-th Tile counting from the front. */
+    void SetDirection(std::size_t i, Direction direction) {
+        SetSlotDirection(Wrap(head_ + i), direction);
+    }
+
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, size_); }
+
+    /** Unpack the Tiles from front to back into the parameter array. */
+    void CopyTo(Tile* out) const {
+        for (std::size_t i = 0; i < size_; ++i) {
+            out[i] = (*this)[i];
+        }
+    }
+
+    /* the push methods require that the snake is not full */
+    void push_front(const Tile& tile) {
+        head_ = (0 == head_) ? (cells_.size() - 1) : (head_ - 1);
+        Store(head_, tile);
+        ++size_;
+    }
+    void push_back(const Tile& tile) {
+        Store(Wrap(head_ + size_), tile);
+        ++size_;
+    }
+
+    /* the pop methods require that the snake is not empty */
+    void pop_front() {
+        head_ = Wrap(head_ + 1);
+        --size_;
+    }
+    void pop_back() { --size_; }
+
+   private:
+    /** Map an unwrapped index in [0, 2 * capacity) into the storage. */
+    std::size_t Wrap(std::size_t i) const {
+        return (i >= cells_.size()) ? (i - cells_.size()) : i;
+    }
+
+    Direction GetDirection(std::size_t slot) const {
+        return GetPackedDirection(directions_.data(), slot);
+    }
+
+    void SetSlotDirection(std::size_t slot, Direction direction) {
+        SetPackedDirection(directions_.data(), slot, direction);
+    }
+
+    void Store(std::size_t slot, const Tile& tile) {
+        cells_[slot] = PackTile(tile);
+        SetSlotDirection(slot, tile.direction);
+    }
+
+    std::conditional_t<kDynamicCapacity == Capacity,
+                       std::pmr::vector<PackedTile>,
+                       std::array<PackedTile, Capacity>>
+        cells_;
+    std::conditional_t<kDynamicCapacity == Capacity,
+                       std::pmr::vector<std::uint8_t>,
+                       std::array<std::uint8_t,
+                                  GetPackedDirectionBytes(Capacity)>>
+        directions_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
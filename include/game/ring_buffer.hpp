@@ -0,0 +1,168 @@
+#ifndef RING_BUFFER_HPP_
+#define RING_BUFFER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+namespace snake {
+namespace game {
+
+/** Capacity of a RingBuffer whose capacity is chosen at run time. */
+constexpr std::size_t kDynamicCapacity = 0;
+
+/**
+ * Fixed capacity double ended queue backed by a circular buffer.
+ *
+ * Elements can be pushed at the front and popped at either end in constant
+ * time without touching the heap. By default, the capacity is chosen at run
+ * time and storage is only (re)allocated, from the buffer's memory resource,
+ * when the capacity changes in Reset(). A non-zero Capacity instead keeps the
+ * elements in a std::array inside the buffer, which never allocates and has
+ * no Reset().
+ */
+template <typename T, std::size_t Capacity = kDynamicCapacity>
+class RingBuffer {
+   public:
+    class ConstIterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+        ConstIterator(const RingBuffer* buffer, std::size_t index)
+            : buffer_(buffer), index_(index) {}
+
+        reference operator*() const { return (*buffer_)[index_]; }
+        pointer operator->() const { return &(*buffer_)[index_]; }
+
+        ConstIterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        ConstIterator operator++(int) {
+            ConstIterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+            return (a.index_ == b.index_);
+        }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        const RingBuffer* buffer_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    using value_type = T;
+    using const_iterator = ConstIterator;
+
+    RingBuffer() = default;
+    explicit RingBuffer(std::size_t capacity) { Reset(capacity); }
+
+    /** Construct an empty dynamic buffer allocating from resource. */
+    explicit RingBuffer(std::pmr::memory_resource* resource)
+        : storage_(resource) {}
+
+    /** Remove all elements and set the capacity of a dynamic buffer. */
+    void Reset(std::size_t capacity) {
+        static_assert(kDynamicCapacity == Capacity,
+                      "the capacity of the buffer is fixed");
+        storage_.resize(capacity);
+        clear();
+    }
+
+    /**
+     * Raise the capacity of a dynamic buffer to at least the parameter
+     * capacity, keeping its elements.
+     */
+    void Grow(std::size_t capacity) {
+        static_assert(kDynamicCapacity == Capacity,
+                      "the capacity of the buffer is fixed");
+        if (capacity <= storage_.size()) {
+            return;
+        }
+        decltype(storage_) storage(capacity, storage_.get_allocator());
+        CopyTo(storage.data());
+        storage_.swap(storage);
+        head_ = 0;
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return storage_.size(); }
+    bool empty() const { return (0 == size_); }
+    bool full() const { return (storage_.size() == size_); }
+
+    /** Return the i-th element counting from the front of the buffer. */
+    const T& operator[](std::size_t i) const {
+        return storage_[Wrap(head_ + i)];
+    }
+    T& operator[](std::size_t i) { return storage_[Wrap(head_ + i)]; }
+
+    const T& front() const { return storage_[head_]; }
+    T& front() { return storage_[head_]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+    T& back() { return (*this)[size_ - 1]; }
+
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, size_); }
+
+    /** Copy the elements from front to back into the parameter array. */
+    void CopyTo(T* out) const {
+        /* the elements wrap around the end of the storage at most once */
+        const std::size_t kFirst = std::min(size_, storage_.size() - head_);
+        std::copy_n(storage_.begin() + head_, kFirst, out);
+        std::copy_n(storage_.begin(), size_ - kFirst, out + kFirst);
+    }
+
+    /* the push methods require that the buffer is not full */
+    void push_front(const T& value) {
+        head_ = (0 == head_) ? (storage_.size() - 1) : (head_ - 1);
+        storage_[head_] = value;
+        ++size_;
+    }
+    void push_back(const T& value) {
+        storage_[Wrap(head_ + size_)] = value;
+        ++size_;
+    }
+
+    /* the pop methods require that the buffer is not empty */
+    void pop_front() {
+        head_ = Wrap(head_ + 1);
+        --size_;
+    }
+    void pop_back() { --size_; }
+
+   private:
+    /** Map an unwrapped index in [0, 2 * capacity) into the storage. */
+    std::size_t Wrap(std::size_t i) const {
+        return (i >= storage_.size()) ? (i - storage_.size()) : i;
+    }
+
+    std::conditional_t<kDynamicCapacity == Capacity, std::pmr::vector<T>,
+                       std::array<T, Capacity>>
+        storage_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef RNG_HPP_
+#define RNG_HPP_
+
+#include <cstdint>
+#include <limits>
+
+namespace snake {
+namespace game {
+
+/**
+ * Return the output of the SplitMix64 generator for the parameter state.
+ *
+ * Useful on its own for deriving well mixed, independent seeds from a base
+ * seed and a counter (e.g., one seed per simulated game).
+ */
+inline std::uint64_t SplitMix64(std::uint64_t state) {
+    std::uint64_t z = state + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Small, fast and seedable pseudo random number generator (xoshiro256**).
+ *
+ * Unlike the standard engines and distributions, the sequence produced for a
+ * given seed is fully specified here so games are reproducible across
+ * platforms and standard library implementations. Rng satisfies the
+ * UniformRandomBitGenerator requirements.
+ */
+class Rng {
+   public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) { Seed(seed); }
+
+    /** Reset the generator to the start of the sequence for the seed. */
+    void Seed(std::uint64_t seed) {
+        for (std::uint64_t& word : state_) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            word = SplitMix64(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        const std::uint64_t kResult = RotateLeft(state_[1] * 5, 7) * 9;
+        const std::uint64_t kShifted = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= kShifted;
+        state_[3] = RotateLeft(state_[3], 45);
+        return kResult;
+    }
+
+    /** Return a uniformly distributed integer in the range [0, bound). */
+    std::uint32_t Below(std::uint32_t bound) {
+        /* Lemire's multiply and reject method, unbiased and almost always a
+         * single multiplication */
+        std::uint64_t product = (operator()() >> 32) * bound;
+        auto low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t kThreshold = -bound % bound;
+            while (low < kThreshold) {
+                product = (operator()() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+   private:
+    static std::uint64_t RotateLeft(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state_[4] = {};
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SNAPSHOT_BUFFER_HPP_
+#define SNAPSHOT_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+
+namespace snake {
+namespace game {
+
+/**
+ * Lock-free handoff of the latest snapshot of some state from exactly one
+ * producer thread to one consumer thread.
+ *
+ * The producer fills its back buffer and publishes it, the consumer draws
+ * from its front buffer. Both are swapped with a third buffer in between
+ * through a single atomic exchange, so neither side ever waits on the other
+ * and a snapshot is never written while it is being read. Publishing again
+ * before the consumer took the last snapshot replaces it, the consumer only
+ * ever sees the latest one.
+ */
+template <typename T>
+class SnapshotBuffer {
+   public:
+    /** Initialize every buffer with a copy of the parameter value. */
+    explicit SnapshotBuffer(const T& value) : buffers_{value, value, value} {}
+
+    /** Return the buffer to fill with the next snapshot, producer side. */
+    T& Back() { return buffers_[back_]; }
+
+    /** Hand the back buffer to the consumer, producer side. */
+    void Publish() {
+        back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) &
+                kIndexMask;
+    }
+
+    /**
+     * Take the latest snapshot into the front buffer, consumer side.
+     *
+     * @returns false, leaving the front buffer as is, if nothing was
+     *          published since the last call.
+     */
+    bool Acquire() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) &
+                 kIndexMask;
+        return true;
+    }
+
+    /** Return the snapshot taken by the last Acquire(), consumer side. */
+    T& Front() { return buffers_[front_]; }
+
+   private:
+    /* the middle buffer's index is tagged while it holds a snapshot the
+     * consumer has not taken */
+    static constexpr unsigned kIndexMask = 0x3;
+    static constexpr unsigned kFresh = 0x4;
+
+    std::array<T, 3> buffers_;
+    unsigned back_ = 0; /**< Producer only. */
+    alignas(64) std::atomic<unsigned> middle_{1};
+    alignas(64) unsigned front_ = 2; /**< Consumer only. */
+};
+
+}  // namespace game
+}  // namespace snake
+
+#endif
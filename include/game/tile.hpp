@@ -0,0 +1,122 @@
+#ifndef TILE_HPP_
+#define TILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace snake {
+namespace game {
+
+enum class Direction {
+    kUp,
+    kDown,
+    kLeft,
+    kRight,
+    kNone,
+};
+
+/**
+ * Representation of a single location on the screen.
+ *
+ * The screen is divided up into a grid of 2D coordinate locations called Tiles.
+ * Tiles can optionally have a direction when they are associated with the
+ * snake.
+ */
+struct Tile {
+    int row = 0;
+    int col = 0;
+    Direction direction = Direction::kNone;
+
+    /* it's hacky but we exclude the direction in the equality comparison
+     * because we want to be able to compare snake tiles with target tiles which
+     * have no direction */
+    friend bool operator==(const Tile& a, const Tile& b) {
+        return ((a.row == b.row) && (a.col == b.col));
+    }
+};
+
+/**
+ * Return the Tile adjacent to the parameter Tile in the parameter direction.
+ *
+ * The returned Tile keeps the direction of the parameter Tile. A direction of
+ * Direction::kNone returns the parameter Tile unchanged.
+ */
+Tile Neighbor(const Tile& tile, const Direction& direction);
+
+/** Return the direction opposite the parameter direction. */
+Direction Opposite(const Direction& direction);
+
+/**
+ * A Tile's row and column packed into the upper and lower 16 bits of a word.
+ *
+ * The direction is left out, see PackedSnake for where it is kept instead.
+ */
+using PackedTile = std::uint32_t;
+
+/**
+ * Largest row or column a PackedTile holds.
+ *
+ * Coordinates are stored as 16-bit two's complement so that the Tile just
+ * off either edge of a board at most this wide and high packs too.
+ */
+constexpr int kMaxPackedCoordinate = INT16_MAX;
+
+/** Return the row and column of the parameter Tile packed into a word. */
+constexpr PackedTile PackTile(const Tile& tile) {
+    return (static_cast<PackedTile>(static_cast<std::uint16_t>(tile.row))
+            << 16) |
+           static_cast<std::uint16_t>(tile.col);
+}
+
+/** Return the Tile at the packed location with the parameter direction. */
+constexpr Tile UnpackTile(PackedTile packed,
+                          Direction direction = Direction::kNone) {
+    return {.row = static_cast<std::int16_t>(packed >> 16),
+            .col = static_cast<std::int16_t>(packed & 0xffff),
+            .direction = direction};
+}
+
+/* directions of movement are packed two bits each, four to a byte */
+constexpr unsigned kPackedDirectionBits = 2;
+constexpr unsigned kPackedDirectionsPerByte = 8 / kPackedDirectionBits;
+
+static_assert((0 == static_cast<int>(Direction::kUp)) &&
+                  (3 == static_cast<int>(Direction::kRight)),
+              "the directions of movement must fit in two bits");
+
+/** Return the number of bytes holding num_directions packed directions. */
+constexpr std::size_t GetPackedDirectionBytes(std::size_t num_directions) {
+    return (num_directions + kPackedDirectionsPerByte - 1) /
+           kPackedDirectionsPerByte;
+}
+
+/** Return the i-th direction of a packed direction stream. */
+inline Direction GetPackedDirection(const std::uint8_t* stream,
+                                    std::size_t i) {
+    const unsigned kShift =
+        kPackedDirectionBits * (i % kPackedDirectionsPerByte);
+    const unsigned kMask = (1U << kPackedDirectionBits) - 1;
+    return static_cast<Direction>(
+        (stream[i / kPackedDirectionsPerByte] >> kShift) & kMask);
+}
+
+/**
+ * Overwrite the i-th direction of a packed direction stream.
+ *
+ * Direction::kNone does not fit and must not be stored.
+ */
+inline void SetPackedDirection(std::uint8_t* stream, std::size_t i,
+                               Direction direction) {
+    const unsigned kShift =
+        kPackedDirectionBits * (i % kPackedDirectionsPerByte);
+    const unsigned kMask = (1U << kPackedDirectionBits) - 1;
+    std::uint8_t& byte = stream[i / kPackedDirectionsPerByte];
+    byte = static_cast<std::uint8_t>(
+        (byte & ~(kMask << kShift)) |
+        ((static_cast<unsigned>(direction) & kMask) << kShift));
+}
+
+}  // namespace game
+}  // namespace snake
+
+#endif
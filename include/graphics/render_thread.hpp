@@ -0,0 +1,124 @@
+#ifndef RENDER_THREAD_HPP_
+#define RENDER_THREAD_HPP_
+
+#include <signal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "game/game.hpp"
+#include "game/input_queue.hpp"
+#include "game/snapshot_buffer.hpp"
+
+namespace snake {
+namespace graphics {
+
+/**
+ * Snapshot of the game handed to the render thread.
+ *
+ * Only the compact state is copied, so publishing a frame costs in proportion
+ * to the snake's length rather than to the board's area.
+ */
+struct Frame {
+    snake::game::GameState state;
+    snake::game::ScreenDimension dim;
+    bool paused = false; /**< Set while the screen is too small for the
+                              game, see SnakeGame::Resize(). */
+};
+
+/**
+ * Draws frames and reads the keypad on a thread of its own.
+ *
+ * Terminal output may take arbitrarily long, e.g., over a slow link, and
+ * ncurses is not thread safe. While a RenderThread runs it is the only thread
+ * to touch the screen or the keypad, so the game thread never waits on the
+ * terminal. The game thread publishes frames through a SnapshotBuffer and the
+ * render thread restores the latest one into a game of its own and draws it,
+ * dropping those it had no time for. Whenever a frame is not the tick after
+ * the one drawn last or the board was resized in between, the renderer draws
+ * the whole board instead of the last tick's changes. Key presses are pushed
+ * to an InputQueue as they arrive and terminal resizes are handed over
+ * through TakeResize().
+ *
+ * The thread which starts a RenderThread has SIGWINCH blocked until Stop() so
+ * that ncurses notices resizes on the render thread.
+ */
+class RenderThread {
+   public:
+    using DrawFunction =
+        std::function<void(const snake::game::SnakeGame& game, bool paused)>;
+
+    /**
+     * Start the render thread, requires InitScreen().
+     *
+     * @param[in] game Game the frames are snapshots of, copied once for the
+     *                 render thread to restore the frames into.
+     * @param[in] input Queue key presses are pushed to, must outlive the
+     *                  render thread.
+     * @param[in] draw Draws the game of a frame and whether it is paused,
+     *                 called on the render thread.
+     */
+    RenderThread(const snake::game::SnakeGame& game,
+                 snake::game::InputQueue& input, DrawFunction draw);
+
+    /** Stop() the render thread. */
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * Hand a snapshot of the game to the render thread.
+     *
+     * Never blocks, saving the game's state into a frame buffer only
+     * allocates when the snake outgrew it.
+     *
+     * @param[in] game Game to draw.
+     * @param[in] paused Whether the game is paused for lack of room.
+     */
+    void Publish(const snake::game::SnakeGame& game, bool paused = false);
+
+    /** Thread safe counterpart of graphics::TakeResize(). */
+    bool TakeResize(snake::game::ScreenDimension& dim);
+
+    /**
+     * Draw the last published frame, unless already drawn, and join the
+     * render thread.
+     */
+    void Stop();
+
+   private:
+    /** Body of the render thread. */
+    void Run();
+
+    /** Wake the render thread up from waiting on the keypad. */
+    void Wake();
+
+    /** Bring view_ to the state of the parameter frame. */
+    void RestoreView(const Frame& frame);
+
+    snake::game::InputQueue& input_;
+    DrawFunction draw_;
+    snake::game::SnapshotBuffer<Frame> frames_;
+    snake::game::SnakeGame view_; /**< Game of the frame drawn last, kept at
+                                       a fixed address so the renderer
+                                       recognizes the next tick of the same
+                                       game, and rebuilt in place on a
+                                       resize, which the renderer tells
+                                       apart by the board's size. */
+
+    /* the latest resize, the width in the upper and the height in the lower
+     * half, or 0 if taken */
+    std::atomic<std::uint64_t> resize_{0};
+    std::atomic<bool> stop_{false};
+    int wake_fd_ = -1;
+    sigset_t prev_mask_;
+    std::thread thread_;
+};
+
+}  // namespace graphics
+}  // namespace snake
+
+#endif
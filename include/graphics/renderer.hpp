@@ -0,0 +1,167 @@
+#ifndef RENDERER_HPP_
+#define RENDERER_HPP_
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace graphics {
+
+/** High score passed to DrawGameOverScreen() when there is none to show. */
+constexpr int kNoHighScore = -1;
+
+/**
+ * Draws the game board and the game over screen.
+ *
+ * A renderer may keep track of what the screen shows in order to redraw only
+ * what changed, see DrawSnakeScreen().
+ */
+class Renderer {
+   public:
+    virtual ~Renderer() = default;
+
+    /**
+     * Draw the game board.
+     *
+     * If the screen shows the previous tick of the same game on a board of
+     * the same size only the Tiles in the game's last TickDelta are redrawn,
+     * otherwise the board is drawn in full.
+     */
+    virtual void DrawSnakeScreen(const snake::game::SnakeGame& game) = 0;
+
+    /**
+     * Draw the game over banner along with the game's score and, unless it is
+     * kNoHighScore, the parameter high score.
+     */
+    virtual void DrawGameOverScreen(const snake::game::SnakeGame& game,
+                                    int high_score) = 0;
+
+    /**
+     * Clear the screen and show a single line message at its center, e.g.,
+     * while the terminal is too small for the game.
+     */
+    virtual void DrawMessageScreen(const snake::game::ScreenDimension& dim,
+                                   const std::string& message) = 0;
+
+    /** Forget what the screen shows, e.g., after something else drew on it. */
+    virtual void Invalidate() = 0;
+};
+
+/** Renderer drawing through ncurses, requires InitScreen(). */
+class CursesRenderer : public Renderer {
+   public:
+    void DrawSnakeScreen(const snake::game::SnakeGame& game) override;
+    void DrawGameOverScreen(const snake::game::SnakeGame& game,
+                            int high_score) override;
+    void DrawMessageScreen(const snake::game::ScreenDimension& dim,
+                           const std::string& message) override;
+    void Invalidate() override { drawn_tick_ = kNoFrame; }
+
+   private:
+    static constexpr std::int64_t kNoFrame = -1;
+
+    const snake::game::SnakeGame* drawn_game_ = nullptr;
+    snake::game::ScreenDimension drawn_dim_;
+    std::int64_t drawn_tick_ = kNoFrame;
+};
+
+/**
+ * Renderer writing ANSI escape sequences straight to a file descriptor.
+ *
+ * Each frame is built into a buffer allocated up front and emitted with a
+ * single write(), skipping the virtual screen ncurses keeps and diffs.
+ * Cursor moves and color changes are only emitted where the previous output
+ * did not already leave the terminal in the required state. Keypad input
+ * still goes through ncurses, which must not draw anything while an
+ * AnsiRenderer is in use.
+ */
+class AnsiRenderer : public Renderer {
+   public:
+    static constexpr std::size_t kDefaultBufferSize = 64 * 1024;
+
+    /**
+     * @param[in] fd File descriptor of the terminal.
+     * @param[in] buffer_size Initial size of the frame buffer, it grows
+     *                        should a frame not fit.
+     */
+    explicit AnsiRenderer(int fd = STDOUT_FILENO,
+                          std::size_t buffer_size = kDefaultBufferSize);
+
+    void DrawSnakeScreen(const snake::game::SnakeGame& game) override;
+    void DrawGameOverScreen(const snake::game::SnakeGame& game,
+                            int high_score) override;
+    void DrawMessageScreen(const snake::game::ScreenDimension& dim,
+                           const std::string& message) override;
+    void Invalidate() override { drawn_tick_ = kNoFrame; }
+
+    /** Return the number of bytes written to the file descriptor. */
+    std::uint64_t GetBytesWritten() const { return bytes_written_; }
+
+   private:
+    static constexpr std::int64_t kNoFrame = -1;
+
+    enum class Style {
+        kUnknown,
+        kPlain,
+        kRed,
+        kGreen,
+        kCyan,
+    };
+
+    /** Make room for at least num_bytes more bytes in the frame buffer. */
+    void Reserve(std::size_t num_bytes);
+
+    void Append(const char* bytes, std::size_t num_bytes);
+    void AppendInt(int value);
+    void MoveTo(int row, int col);
+    void SetStyle(Style style);
+
+    /** Draw a character in the parameter style at the parameter Tile. */
+    void DrawChar(const snake::game::Tile& tile, Style style, char c);
+
+    void DrawTarget(const snake::game::Tile& target);
+    void DrawSnakeHead(const snake::game::Tile& head);
+    void DrawBorder(const snake::game::ScreenDimension& dim);
+
+    /** Clear the screen and reset the cursor and style. */
+    void ClearScreen(const snake::game::ScreenDimension& dim);
+
+    /** Write the frame buffer out and empty it. */
+    void Flush();
+
+    int fd_;
+    std::vector<char> buffer_;
+    std::size_t len_ = 0;
+    std::uint64_t bytes_written_ = 0;
+
+    /* terminal state left behind by the output so far */
+    int width_ = 0;
+    int cursor_row_ = -1;
+    int cursor_col_ = -1;
+    Style style_ = Style::kUnknown;
+
+    const snake::game::SnakeGame* drawn_game_ = nullptr;
+    snake::game::ScreenDimension drawn_dim_;
+    std::int64_t drawn_tick_ = kNoFrame;
+};
+
+/** Renderer which draws nothing, e.g., to time the game loop without it. */
+class NullRenderer : public Renderer {
+   public:
+    void DrawSnakeScreen(const snake::game::SnakeGame&) override {}
+    void DrawGameOverScreen(const snake::game::SnakeGame&, int) override {}
+    void DrawMessageScreen(const snake::game::ScreenDimension&,
+                           const std::string&) override {}
+    void Invalidate() override {}
+};
+
+}  // namespace graphics
+}  // namespace snake
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef SCREEN_HPP_
 #define SCREEN_HPP_
 
+#include <cstdint>
+#include <string>
+
 #include "game/game.hpp"
+#include "graphics/renderer.hpp"
 
 namespace snake {
 namespace graphics {
@@ -21,14 +25,72 @@ enum class GameMode {
 snake::game::ScreenDimension InitScreen();
 void TerminateScreen();
 
+/**
+ * Return the total number of bytes the process has written so far.
+ *
+ * Since drawing is the only output while the game runs, the difference
+ * between two calls around a draw is the number of bytes sent to the
+ * terminal for that frame. Returns 0 where the kernel does not report it.
+ */
+std::uint64_t GetBytesWritten();
+
 void EnableInputDelay(int delay_ms);
 void DisableInputDelay();
 
 snake::game::Direction ReadKeypad();
 
+/**
+ * Wait at most timeout_ms milliseconds for a key press.
+ *
+ * Unlike ReadKeypad(), a timeout can be told apart from a key which does not
+ * map to a direction. The input delay is left set to timeout_ms.
+ *
+ * @param[in] timeout_ms Time to wait, 0 returns immediately.
+ * @param[out] direction Direction of the arrow key pressed or
+ *                       Direction::kNone for any other key.
+ * @returns true if a key was pressed.
+ */
+bool PollKeypad(int timeout_ms, snake::game::Direction& direction);
+
+/**
+ * Return the new screen dimensions if the terminal was resized.
+ *
+ * ReadKeypad() and PollKeypad() pick up resizes as they read the keypad, a
+ * resize being reported as a key which does not map to a direction. Any
+ * number of resizes since the last call are reported once, with the latest
+ * dimensions. The selected renderer redraws in full after a resize.
+ *
+ * @param[out] dim Dimensions of the resized screen.
+ * @returns true if the terminal was resized since the last call.
+ */
+bool TakeResize(snake::game::ScreenDimension& dim);
+
+/**
+ * Select the renderer behind DrawSnakeScreen() and DrawGameOverScreen().
+ *
+ * The renderer must outlive its use, nullptr selects the default ncurses
+ * renderer.
+ */
+void SetRenderer(Renderer* renderer);
+
 GameMode PromptForGameMode();
+
+/** Draw the game board with the selected renderer. */
 void DrawSnakeScreen(const snake::game::SnakeGame& game);
-void DrawGameOverScreen(const snake::game::SnakeGame& game);
+
+/** Show a single line message with the selected renderer. */
+void DrawMessageScreen(const std::string& message);
+
+/**
+ * Draw the game over screen with the selected renderer and wait for the user
+ * to press 'q'.
+ *
+ * @param[in] game The game which ended.
+ * @param[in] high_score Best score to show next to the game's own, see
+ *                       Renderer::DrawGameOverScreen().
+ */
+void DrawGameOverScreen(const snake::game::SnakeGame& game,
+                        int high_score = kNoHighScore);
 
 }  // namespace graphics
 }  // namespace snake
@@ -0,0 +1,22 @@
+#ifndef ALLOC_HOOKS_HPP_
+#define ALLOC_HOOKS_HPP_
+
+#include <cstdint>
+
+namespace snake {
+namespace metrics {
+
+/**
+ * Return the number of heap allocations made by the process so far.
+ *
+ * Allocations are counted by replacements of the global operator new and
+ * delete defined next to this function, so they are only counted in programs
+ * linking the alloc_hooks library, e.g., the benchmarks, the allocation tests
+ * and builds with SNAKE_METRICS defined.
+ */
+std::uint64_t GetNumAllocations();
+
+}  // namespace metrics
+}  // namespace snake
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef METRICS_HPP_
+#define METRICS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+
+namespace snake {
+namespace metrics {
+
+enum class Metric {
+    kTickLatency,   /**< Time spent in SnakeGame::Tick() in ns. */
+    kRenderLatency, /**< Time spent drawing a frame in ns. */
+    kInputLatency,  /**< Time spent reading the keypad in ns. */
+    kSnakeLength,   /**< Snake length after every tick in Tiles. */
+    kAllocations,   /**< Heap allocations per frame. */
+};
+
+constexpr int kNumMetrics = 5;
+
+/** Whether the instrumentation hooks are compiled in. */
+#ifdef SNAKE_METRICS
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+/** Return the name under which the parameter metric is exported. */
+const char* MetricName(Metric metric);
+
+/** Return the unit of the parameter metric's samples. */
+const char* MetricUnit(Metric metric);
+
+/**
+ * Fixed size log-linear histogram of unsigned samples.
+ *
+ * Every power of two range is split into kSubBuckets equal buckets, so any
+ * value is reported within 1 / kSubBuckets of its true value while the whole
+ * 64-bit range fits in fewer than a thousand counters. Recording a sample
+ * costs a few instructions and never allocates.
+ */
+class Histogram {
+   public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    void Record(std::uint64_t value) {
+        counts_[BucketIndex(value)]++;
+        if (!count_ || (value < min_)) {
+            min_ = value;
+        }
+        if (value > max_) {
+            max_ = value;
+        }
+        count_++;
+        sum_ += value;
+    }
+
+    void Clear();
+
+    std::uint64_t GetCount() const { return count_; }
+    std::uint64_t GetMin() const { return min_; }
+    std::uint64_t GetMax() const { return max_; }
+    double GetMean() const {
+        return count_ ? (static_cast<double>(sum_) / count_) : 0.0;
+    }
+
+    /**
+     * Return the value below which the parameter fraction of samples lie.
+     *
+     * @param[in] quantile Fraction of samples in [0, 1].
+     * @returns The upper bound of the bucket holding the quantile, clamped to
+     *          the largest sample, or 0 if the histogram is empty.
+     */
+    std::uint64_t GetValueAtQuantile(double quantile) const;
+
+    std::uint64_t GetBucketCount(int bucket) const { return counts_[bucket]; }
+
+    /** Return the smallest value counted in the parameter bucket. */
+    static std::uint64_t BucketLowerBound(int bucket);
+
+    /** Return the largest value counted in the parameter bucket. */
+    static std::uint64_t BucketUpperBound(int bucket);
+
+   private:
+    static int BucketIndex(std::uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<int>(value);
+        }
+        const int kMsb = 63 - __builtin_clzll(value);
+        const int kShift = kMsb - kSubBucketBits;
+        return (kShift + 1) * kSubBuckets +
+               static_cast<int>((value >> kShift) - kSubBuckets);
+    }
+
+    std::array<std::uint64_t, kNumBuckets> counts_ = {};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t min_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+/**
+ * One Histogram per Metric and an optional local stream of raw samples.
+ *
+ * When connected to a Unix domain socket, every sample is also appended as a
+ * "name,value" line to a fixed buffer which is sent with a single non-blocking
+ * write whenever it fills up or Flush() is called. Samples which no longer fit
+ * because the listener falls behind are dropped rather than stalling the game.
+ *
+ * Samples may be recorded from several threads, e.g., the game and the render
+ * thread. The histograms must only be read once those threads are done.
+ */
+class Recorder {
+   public:
+    Recorder() = default;
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    void Record(Metric metric, std::uint64_t value);
+
+    const Histogram& GetHistogram(Metric metric) const {
+        return histograms_[static_cast<int>(metric)];
+    }
+
+    /**
+     * Stream samples to the Unix domain socket listening at path.
+     *
+     * @param[in] path Filesystem path of a SOCK_STREAM listener.
+     * @returns false if the socket could not be connected.
+     */
+    bool ConnectSocket(const char* path);
+
+    /** Send as many buffered samples as the socket takes without blocking. */
+    void Flush();
+
+    /**
+     * Mark the end of a frame.
+     *
+     * Records the heap allocations made since the previous call, if any, as a
+     * Metric::kAllocations sample and flushes the socket stream.
+     */
+    void EndFrame();
+
+    /** Return the number of samples not streamed because the buffer was
+     * full. */
+    std::uint64_t GetNumDropped() const { return num_dropped_; }
+
+    /** Write a summary and the non-empty buckets of every histogram. */
+    bool WriteJson(std::ostream& os) const;
+
+    /** Write a summary of every histogram, one metric per row. */
+    bool WriteCsv(std::ostream& os) const;
+
+   private:
+    static constexpr std::size_t kBufferSize = 4096;
+
+    /* Record() and Flush() with mutex_ held */
+    void RecordLocked(Metric metric, std::uint64_t value);
+    void FlushLocked();
+
+    std::mutex mutex_;
+
+    std::array<Histogram, kNumMetrics> histograms_;
+    bool in_frame_ = false;
+    std::uint64_t frame_allocations_ = 0;
+
+    int socket_fd_ = -1;
+    std::array<char, kBufferSize> buffer_ = {};
+    std::size_t buffer_len_ = 0;
+    std::uint64_t num_dropped_ = 0;
+};
+
+/** Return the process wide Recorder the instrumentation hooks record to. */
+Recorder& GlobalRecorder();
+
+/** Record the lifetime of the object in ns to the global Recorder. */
+class ScopedTimer {
+   public:
+    explicit ScopedTimer(Metric metric)
+        : metric_(metric), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        const auto kElapsed = std::chrono::steady_clock::now() - start_;
+        GlobalRecorder().Record(
+            metric_,
+            static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(kElapsed)
+                    .count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    Metric metric_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace metrics
+}  // namespace snake
+
+/*
+ * Instrumentation hooks. Unless SNAKE_METRICS is defined they expand to
+ * nothing, their arguments are not evaluated and they cost nothing.
+ *
+ * SNAKE_METRICS_TIME(metric)          time the rest of the enclosing scope
+ * SNAKE_METRICS_RECORD(metric, value) record a single sample
+ * SNAKE_METRICS_END_FRAME()           see Recorder::EndFrame()
+ */
+#ifdef SNAKE_METRICS
+#define SNAKE_METRICS_CONCAT_(a, b) a##b
+#define SNAKE_METRICS_CONCAT(a, b) SNAKE_METRICS_CONCAT_(a, b)
+#define SNAKE_METRICS_TIME(metric)                               \
+    ::snake::metrics::ScopedTimer SNAKE_METRICS_CONCAT(          \
+        snake_metrics_timer_, __LINE__)(::snake::metrics::metric)
+#define SNAKE_METRICS_RECORD(metric, value) \
+    ::snake::metrics::GlobalRecorder().Record(::snake::metrics::metric, value)
+#define SNAKE_METRICS_END_FRAME() \
+    ::snake::metrics::GlobalRecorder().EndFrame()
+#else
+#define SNAKE_METRICS_TIME(metric) static_cast<void>(0)
+#define SNAKE_METRICS_RECORD(metric, value) static_cast<void>(0)
+#define SNAKE_METRICS_END_FRAME() static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef PROTOCOL_HPP_
+#define PROTOCOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace net {
+
+/**
+ * Append a snapshot frame holding the full state of the game to out.
+ *
+ * A spectator joins, or rejoins after falling too far behind, by receiving a
+ * snapshot and then one delta frame per tick. Snapshots encode the snake as
+ * its head Tile followed by four bits per Tile holding the Tile's direction,
+ * from which the next Tile towards the tail follows.
+ */
+void EncodeSnapshot(const snake::game::SnakeGame& game,
+                    std::vector<std::uint8_t>& out);
+
+/**
+ * Append a delta frame describing the game's last tick to out.
+ *
+ * The frame is a single byte holding the direction of the new head and
+ * whether the snake grew, the target moved and the game ended. The head, and
+ * the tail which left its Tile unless the snake grew, follow from the
+ * direction. Only a tick which grew the snake adds its new score and only a
+ * tick which moved the target adds its new Tile.
+ */
+void EncodeDelta(const snake::game::SnakeGame& game,
+                 std::vector<std::uint8_t>& out);
+
+/**
+ * A spectator's copy of a game rebuilt from a stream of frames.
+ *
+ * Deltas are applied with the same rules SnakeGame uses to move and extend
+ * the snake, so the Tiles of the view, directions included, match those of
+ * the game after every frame.
+ */
+class SpectatorView {
+   public:
+    /**
+     * Apply every complete frame within the bytes received so far.
+     *
+     * Bytes of a frame which is not yet complete are kept until the rest of
+     * it arrives.
+     *
+     * @returns false if the stream is malformed, in which case the view is
+     * left in an unspecified state.
+     */
+    bool Feed(const std::uint8_t* data, std::size_t len);
+
+    /** Return true once the view has received a snapshot. */
+    bool HasGame() const { return has_game_; }
+
+    snake::game::ScreenDimension GetScreenDimension() const {
+        return screen_dim_;
+    }
+    int GetBorder() const { return border_; }
+    int GetScore() const { return score_; }
+    std::int64_t GetTicks() const { return ticks_; }
+    bool GameOver() const { return game_over_; }
+    const snake::game::Tile& GetTargetTile() const { return target_; }
+    const snake::game::Snake& GetSnake() const { return snake_; }
+
+    std::uint64_t GetNumFrames() const { return num_frames_; }
+    std::uint64_t GetNumSnapshots() const { return num_snapshots_; }
+
+   private:
+    static constexpr std::ptrdiff_t kMalformed = -1;
+
+    /**
+     * Decode and apply the frame at the start of the parameter bytes.
+     *
+     * @returns The number of bytes the frame took, 0 if it is incomplete or
+     * kMalformed.
+     */
+    std::ptrdiff_t DecodeFrame(const std::uint8_t* data, std::size_t len);
+    std::ptrdiff_t DecodeSnapshot(const std::uint8_t* data, std::size_t len);
+    std::ptrdiff_t DecodeDelta(const std::uint8_t* data, std::size_t len);
+
+    bool has_game_ = false;
+    snake::game::ScreenDimension screen_dim_;
+    int border_ = 0;
+    int score_ = 0;
+    std::int64_t ticks_ = 0;
+    bool game_over_ = false;
+    snake::game::Tile target_;
+    snake::game::Snake snake_;
+    std::uint64_t num_frames_ = 0;
+    std::uint64_t num_snapshots_ = 0;
+    std::vector<std::uint8_t> pending_; /**< Start of an incomplete frame. */
+};
+
+}  // namespace net
+}  // namespace snake
+
+#endif
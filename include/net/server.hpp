@@ -0,0 +1,118 @@
+#ifndef SERVER_HPP_
+#define SERVER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace net {
+
+/**
+ * Streams a game to any number of spectators connected over a socket.
+ *
+ * The game stays authoritative, spectators only ever receive. Each tick is
+ * encoded once into a log shared by every spectator, see EncodeDelta(), and
+ * each spectator keeps its own position within the log. Update() sends every
+ * spectator everything it has not seen yet with a single non-blocking write,
+ * so the ticks of a frame leave in one batch and a slow spectator never holds
+ * up the game or the other spectators.
+ *
+ * A spectator joins with a snapshot of the game, see EncodeSnapshot(). One
+ * that falls more than max_lag bytes behind is sent a fresh snapshot instead
+ * of the ticks it missed, which bounds both the bytes queued for and the
+ * bandwidth taken by a spectator that cannot keep up. A spectator which falls
+ * behind again before it has taken that snapshot is disconnected.
+ */
+class SpectatorServer {
+   public:
+    static constexpr std::size_t kDefaultMaxLag = 64 * 1024;
+
+    /**
+     * @param[in] max_lag Bytes a spectator may fall behind before it is sent
+     *                    a snapshot instead.
+     */
+    explicit SpectatorServer(std::size_t max_lag = kDefaultMaxLag);
+    ~SpectatorServer();
+
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+
+    /**
+     * Start accepting spectators at the parameter address, see OpenListener().
+     *
+     * @returns false if the address could not be listened on.
+     */
+    bool Listen(const char* address);
+
+    /** Queue the game's last tick for every spectator, call after Tick(). */
+    void Broadcast(const snake::game::SnakeGame& game);
+
+    /**
+     * Queue a snapshot of the game for every spectator, call after anything
+     * other than a single Tick() changed the game (e.g., Reset()).
+     */
+    void BroadcastSnapshot(const snake::game::SnakeGame& game);
+
+    /**
+     * Accept waiting spectators and send everyone the frames queued since the
+     * last update. Call once per frame, the game only being used to build
+     * snapshots.
+     */
+    void Update(const snake::game::SnakeGame& game);
+
+    std::size_t GetNumSpectators() const { return spectators_.size(); }
+    std::uint64_t GetBytesSent() const { return bytes_sent_; }
+    std::uint64_t GetNumResyncs() const { return num_resyncs_; }
+    std::uint64_t GetNumDropped() const { return num_dropped_; }
+
+   private:
+    struct Spectator {
+        int fd = -1;
+        std::vector<std::uint8_t> direct; /**< Bytes sent ahead of the log,
+                                               i.e., a snapshot. */
+        std::size_t direct_sent = 0;      /**< Bytes of direct already sent. */
+        std::uint64_t offset = 0;         /**< Log position of the next byte
+                                               to send after direct. */
+    };
+
+    /** Return the log position one past the last byte queued. */
+    std::uint64_t LogEnd() const { return log_base_ + log_.size(); }
+
+    void AcceptSpectators(const snake::game::SnakeGame& game);
+
+    /** Replace the rest of the log with a snapshot for the spectator. */
+    void Resync(Spectator& spectator, const snake::game::SnakeGame& game);
+
+    /**
+     * Write as much of the spectator's queued bytes as the socket takes.
+     *
+     * @returns false if the spectator went away.
+     */
+    bool Send(Spectator& spectator);
+
+    /** Drop the part of the log every spectator has been sent. */
+    void TrimLog();
+
+    std::size_t max_lag_;
+    int listen_fd_ = -1;
+    std::string unix_path_; /**< Path to remove on exit, if any. */
+    std::vector<Spectator> spectators_;
+
+    std::vector<std::uint8_t> log_;
+    std::uint64_t log_base_ = 0; /**< Log position of log_[0]. */
+    std::vector<std::uint64_t> frame_starts_; /**< Log position of every frame
+                                                   still in log_. */
+
+    std::uint64_t bytes_sent_ = 0;
+    std::uint64_t num_resyncs_ = 0;
+    std::uint64_t num_dropped_ = 0;
+};
+
+}  // namespace net
+}  // namespace snake
+
+#endif
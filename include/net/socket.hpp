@@ -0,0 +1,31 @@
+#ifndef SOCKET_HPP_
+#define SOCKET_HPP_
+
+namespace snake {
+namespace net {
+
+/*
+ * Addresses are either a TCP port number, in which case only connections from
+ * the local host (127.0.0.1) are accepted, or the path of a Unix socket.
+ */
+
+/**
+ * Open a non-blocking socket listening at the parameter address.
+ *
+ * A stale Unix socket left behind at the path is replaced.
+ *
+ * @returns The socket's descriptor or -1 on failure.
+ */
+int OpenListener(const char* address);
+
+/**
+ * Open a blocking socket connected to the parameter address.
+ *
+ * @returns The socket's descriptor or -1 on failure.
+ */
+int OpenConnection(const char* address);
+
+}  // namespace net
+}  // namespace snake
+
+#endif
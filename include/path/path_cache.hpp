@@ -0,0 +1,109 @@
+#ifndef PATH_CACHE_HPP_
+#define PATH_CACHE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace path {
+
+/**
+ * Shortest path from the snake's head to the target, kept across ticks.
+ *
+ * A path is planned with A* over the Tiles that are free when it is planned.
+ * Since the only Tiles the snake newly covers as it moves along the path are
+ * the path's own, the rest of the path stays free until the head reaches the
+ * target. A new path is therefore only planned when the target moves, when
+ * the head leaves the path (e.g., because the caller went a different way) or
+ * when the next Tile of the path is found blocked. Following a path costs
+ * O(1) per tick and planning one costs roughly the number of Tiles expanded,
+ * which on open boards is proportional to the path length, so the cost per
+ * tick is close to constant on average.
+ *
+ * All search state lives in flat per cell arrays and preallocated frontier
+ * buffers which are only allocated when the board size changes. The arrays
+ * are stamped with a search number instead of being cleared between searches.
+ * A search that fails visits every Tile reachable from the head, so after a
+ * failure the next search is put off for a number of ticks which doubles with
+ * every further failure until a path is found or the target moves.
+ */
+class PathCache {
+   public:
+    /**
+     * Return the direction of the next step toward the target.
+     *
+     * @param[in] game Game whose snake should reach the target.
+     * @param[out] direction The direction to pass to SnakeGame::Tick().
+     * @returns false if no path to the target exists at the moment.
+     */
+    bool NextDirection(const snake::game::SnakeGame& game,
+                       snake::game::Direction& direction);
+
+    /** Forget the current path so the next call plans a new one. */
+    void Invalidate() {
+        path_.clear();
+        retry_tick_ = 0;
+        retry_backoff_ = 1;
+    }
+
+    /** Return the number of Tiles between the head and the target, or -1 if
+     * there is no current path. */
+    int GetDistance() const {
+        return path_.empty()
+                   ? -1
+                   : static_cast<int>(path_.size() - 1 - head_index_);
+    }
+
+    std::int64_t GetNumPlans() const { return num_plans_; }
+    std::int64_t GetNumExpanded() const { return num_expanded_; }
+
+   private:
+    static constexpr int kNoCell = -1;
+    static constexpr std::int64_t kMaxRetryBackoff = 64;
+
+    /** Size the per cell arrays for the parameter game's board. */
+    void Resize(const snake::game::SnakeGame& game);
+
+    /** Plan a path from the head to the target, returns false if there is
+     * none. */
+    bool Plan(const snake::game::SnakeGame& game);
+
+    int CellIndex(int row, int col) const {
+        return row * screen_dim_.width + col;
+    }
+
+    snake::game::ScreenDimension screen_dim_;
+    snake::game::Tile target_ = {.row = -1, .col = -1};
+
+    /* the path from the head (front) to the target (back) and the index of
+     * the path cell the head was on when last asked */
+    std::vector<int> path_;
+    std::size_t head_index_ = 0;
+
+    /* per cell search state, valid where the stamp matches search_ */
+    std::uint32_t search_ = 0;
+    std::vector<std::uint32_t> seen_;
+    std::vector<std::uint32_t> closed_;
+    std::vector<int> cost_;
+    std::vector<int> parent_;
+
+    /* cells whose estimated total cost is the current bound and the bound
+     * plus two, the only two values possible with the Manhattan heuristic */
+    std::vector<int> frontier_;
+    std::vector<int> next_frontier_;
+
+    /* tick before which no search is started after a failed one and the
+     * number of ticks the next failure puts the search off for */
+    std::int64_t retry_tick_ = 0;
+    std::int64_t retry_backoff_ = 1;
+
+    std::int64_t num_plans_ = 0;
+    std::int64_t num_expanded_ = 0;
+};
+
+}  // namespace path
+}  // namespace snake
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef PLAYER_HPP_
+#define PLAYER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "replay/replay.hpp"
+
+namespace snake {
+namespace replay {
+
+/**
+ * Rebuilds the game state at any tick of a replay.
+ *
+ * Playback fast-forwards a headless SnakeGame through the recorded directions.
+ * While doing so the player keeps a copy of the game every checkpoint interval
+ * ticks, so seeking backwards, or forwards past the furthest tick played so
+ * far, starts from the closest earlier checkpoint instead of from tick 0.
+ * The game at a tick has been resized by every resize recorded at or before
+ * that tick.
+ *
+ * A checkpoint has to be a full copy of the game, since targets spawned after
+ * restoring a GameState may differ from the recorded ones. To bound the
+ * memory the copies take, at most kMaxCheckpoints are kept. Once that many
+ * have been taken every other one is dropped and the interval doubles, so a
+ * seek replays at most a 2 / kMaxCheckpoints share of the ticks played.
+ */
+class ReplayPlayer {
+   public:
+    static const std::int64_t kDefaultCheckpointInterval = 1024;
+    static const std::size_t kMaxCheckpoints = 64;
+
+    /**
+     * @param[in] replay Replay to play back.
+     * @param[in] checkpoint_interval Ticks between saved copies of the game
+     *                                until kMaxCheckpoints have been saved.
+     */
+    explicit ReplayPlayer(
+        const Replay& replay,
+        std::int64_t checkpoint_interval = kDefaultCheckpointInterval);
+
+    const snake::game::SnakeGame& GetGame() const { return game_; }
+    const Replay& GetReplay() const { return replay_; }
+
+    /** Return the number of ticks played to reach the current game state. */
+    std::int64_t GetTick() const { return tick_; }
+
+    /** Return the number of ticks in the replay. */
+    std::int64_t NumTicks() const {
+        return run_ends_.empty() ? 0 : run_ends_.back();
+    }
+
+    std::size_t NumCheckpoints() const { return checkpoints_.size(); }
+
+    /** Return the number of ticks between the current checkpoints. */
+    std::int64_t GetCheckpointInterval() const { return checkpoint_interval_; }
+
+    /**
+     * Bring the game to its state after the parameter number of ticks.
+     *
+     * @param[in] tick Tick to seek to, clamped to [0, NumTicks()].
+     */
+    void Seek(std::int64_t tick);
+
+   private:
+    /** Play forward from the current tick to the parameter tick. */
+    void PlayTo(std::int64_t tick);
+
+    /**
+     * Apply the resizes recorded at the current tick, starting with the
+     * parameter resize.
+     *
+     * @returns The index of the first resize recorded after the current tick.
+     */
+    std::size_t ApplyResizes(std::size_t resize);
+
+    /** Drop every other checkpoint and double the checkpoint interval. */
+    void ThinCheckpoints();
+
+    Replay replay_;
+    std::int64_t checkpoint_interval_;
+    std::vector<std::int64_t> run_ends_; /**< Tick at which each run ends. */
+    std::vector<snake::game::SnakeGame> checkpoints_; /**< The i-th entry is
+                                                           the game after i
+                                                           intervals. */
+    snake::game::SnakeGame game_;
+    std::int64_t tick_;
+};
+
+}  // namespace replay
+}  // namespace snake
+
+#endif
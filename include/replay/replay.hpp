@@ -0,0 +1,78 @@
+#ifndef REPLAY_HPP_
+#define REPLAY_HPP_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "game/game.hpp"
+
+namespace snake {
+namespace replay {
+
+/** A direction repeated for a number of consecutive ticks. */
+struct Run {
+    snake::game::Direction direction = snake::game::Direction::kNone;
+    std::int64_t ticks = 0;
+};
+
+/** A SnakeGame::Resize() made once a number of ticks had been played. */
+struct Resize {
+    std::int64_t tick = 0;
+    snake::game::ScreenDimension dim;
+};
+
+/**
+ * Everything needed to play a game again tick for tick.
+ *
+ * A SnakeGame constructed with Rng(seed), or reset with Reset(seed), on a
+ * board with the recorded dimensions and border and ticked with the recorded
+ * directions, resized to the recorded dimensions in between, plays out
+ * exactly like the recorded game. The directions are stored run-length
+ * encoded since the snake mostly keeps going straight.
+ */
+struct Replay {
+    std::uint64_t seed = 0;
+    snake::game::ScreenDimension dim;
+    int border = 1;
+    std::vector<Run> runs;
+    std::vector<Resize> resizes; /**< In order of their ticks. */
+
+    /** Return the number of ticks recorded. */
+    std::int64_t NumTicks() const;
+
+    /** Record the direction passed to the next SnakeGame::Tick(). */
+    void Append(snake::game::Direction direction);
+
+    /** Record a successful SnakeGame::Resize() after the ticks so far. */
+    void AppendResize(const snake::game::ScreenDimension& new_dim);
+};
+
+/**
+ * Write a replay in the binary replay format.
+ *
+ * The format is a fixed size little endian header (magic, version, seed,
+ * width, height, border and run count) followed by one variable length
+ * integer per run holding the run's tick count shifted left by three bits and
+ * its direction in the low three bits. A straight run of up to 15 ticks
+ * therefore takes a single byte. Replays of resized games are written as
+ * version 2, which appends a variable length integer count of resizes and
+ * then the tick, width and height of each resize as variable length integers.
+ *
+ * @returns false if writing to the stream failed.
+ */
+bool WriteReplay(std::ostream& os, const Replay& replay);
+
+/**
+ * Read a replay written by WriteReplay().
+ *
+ * @returns false if the stream is not a valid replay, in which case the
+ * parameter replay is left in an unspecified state.
+ */
+bool ReadReplay(std::istream& is, Replay& replay);
+
+}  // namespace replay
+}  // namespace snake
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef SCORE_STORE_HPP_
+#define SCORE_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace snake {
+namespace scores {
+
+/** GameRecord::flags bits. */
+constexpr std::uint8_t kWonFlag = 0x1;       /**< The snake filled the board. */
+constexpr std::uint8_t kAutopilotFlag = 0x2; /**< The autopilot played. */
+
+/**
+ * Summary of a single finished game.
+ *
+ * Records are stored in the score file exactly as laid out here, so the
+ * layout must only ever change along with the file version.
+ */
+struct GameRecord {
+    std::int64_t end_time_ms = 0; /**< Unix time the game ended at. */
+    std::int64_t duration_ms = 0; /**< Wall time the game was played for. */
+    std::int64_t ticks = 0;
+    std::int32_t score = 0;
+    std::uint32_t length = 0; /**< Final length of the snake. */
+    std::uint16_t width = 0;  /**< Board size including the border. */
+    std::uint16_t height = 0;
+    std::uint8_t mode = 0; /**< The snake::graphics::GameMode played. */
+    std::uint8_t flags = 0;
+    std::uint16_t reserved = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<GameRecord> &&
+                  (40 == sizeof(GameRecord)),
+              "game records are stored as raw bytes");
+
+/** Selects the records a leaderboard or summary is built from. */
+struct ScoreKey {
+    static constexpr int kAnyMode = -1;
+
+    int mode = kAnyMode; /**< GameRecord::mode or kAnyMode. */
+    int width = 0;       /**< Board width or 0 for any board. */
+    int height = 0;      /**< Board height or 0 for any board. */
+
+    /** Return true if the parameter record belongs to the key. */
+    bool Matches(const GameRecord& record) const {
+        return ((kAnyMode == mode) || (record.mode == mode)) &&
+               ((0 == width) || (record.width == width)) &&
+               ((0 == height) || (record.height == height));
+    }
+};
+
+/** Totals over the games of a ScoreKey. */
+struct ScoreSummary {
+    std::int64_t games = 0;
+    std::int64_t wins = 0;
+    std::int64_t total_score = 0;
+    std::int64_t total_ticks = 0;
+    std::int64_t total_duration_ms = 0;
+    int high_score = 0;
+    std::uint32_t max_length = 0;
+};
+
+/**
+ * Persistent, append-only store of GameRecords in a memory-mapped file.
+ *
+ * The file is a small header followed by the records in the order they were
+ * appended. It is mapped into memory whole, so opening a store holding
+ * millions of records costs a few system calls and the records are read in
+ * place without being parsed. Appending copies the record into the mapping
+ * and only then bumps the record count in the header, which a crash can thus
+ * never leave pointing at a partial record. Nothing is synced to disk
+ * explicitly, the kernel writes the mapped pages back in its own time. The
+ * file grows by doubling, so appends which need to grow it are rare.
+ *
+ * Several processes may append to the same file, appends being serialized
+ * with an advisory lock on it. A store only sees records appended by other
+ * processes once it appends itself or is opened again.
+ */
+class ScoreStore {
+   public:
+    ScoreStore() = default;
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    /**
+     * Open the score file at the parameter path, creating it if missing.
+     *
+     * @returns false if the file could not be created, read or mapped or is
+     *          not a score file.
+     */
+    bool Open(const std::string& path);
+
+    /** Unmap and close the file, a no-op if not open. */
+    void Close();
+
+    bool IsOpen() const { return (fd_ >= 0); }
+
+    /**
+     * Append a record to the file.
+     *
+     * Invalidates pointers returned by GetRecords().
+     *
+     * @returns false if the file could not be grown.
+     */
+    bool Append(const GameRecord& record);
+
+    /** Return the number of records in the store. */
+    std::size_t Size() const { return size_; }
+
+    /** Return the records in the order they were appended. */
+    const GameRecord* GetRecords() const { return records_; }
+
+    /**
+     * Return the highest scoring games of the parameter key, best first and
+     * the earlier of equal scores first. Autopilot games are left out.
+     *
+     * @param[in] key Games to rank.
+     * @param[in] num_scores Maximum number of games to return.
+     */
+    std::vector<GameRecord> GetHighScores(const ScoreKey& key,
+                                          std::size_t num_scores) const;
+
+    /**
+     * Look up the best score of the games of a single mode and board size,
+     * autopilot games left out.
+     *
+     * The best score of every mode and board is indexed as records are first
+     * looked at, so the first call reads every record and later calls only
+     * those appended since.
+     *
+     * @param[in] key Mode and board, neither may be left open.
+     * @param[out] score The best score, set only if there is one.
+     * @returns false if no game of the key was played by hand.
+     */
+    bool GetBestScore(const ScoreKey& key, int& score) const;
+
+    /** Return the totals over the games of the parameter key, autopilot
+     * games included. */
+    ScoreSummary Summarize(const ScoreKey& key) const;
+
+    /** Return the distinct modes and board sizes of the stored games. */
+    std::vector<ScoreKey> GetKeys() const;
+
+   private:
+    /**
+     * Map the file's first map_bytes bytes, replacing any earlier mapping.
+     *
+     * @returns false if the file could not be mapped.
+     */
+    bool Map(std::size_t map_bytes);
+
+    /** Grow the file to twice its capacity or the initial capacity. */
+    bool Grow();
+
+    /** Return true if the mapped header is that of a score file. */
+    bool IsValidHeader() const;
+
+    /** Update size_ from the record count in the header, requires the file
+     * lock. */
+    void LoadSize();
+
+    int fd_ = -1;
+    void* map_ = nullptr;
+    std::size_t map_bytes_ = 0;
+    std::size_t capacity_ = 0; /**< Records the mapping has room for. */
+    std::size_t size_ = 0;
+    GameRecord* records_ = nullptr;
+
+    /* best score by mode, width and height of the first num_indexed_
+     * records, see GetBestScore() */
+    mutable std::map<std::tuple<int, int, int>, int> best_scores_;
+    mutable std::size_t num_indexed_ = 0;
+};
+
+/**
+ * Return the path of the user's default score file, ~/.snake_scores, or an
+ * empty string if the home directory is unknown.
+ */
+std::string GetDefaultScorePath();
+
+}  // namespace scores
+}  // namespace snake
+
+#endif
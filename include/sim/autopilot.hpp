@@ -0,0 +1,97 @@
+#ifndef AUTOPILOT_HPP_
+#define AUTOPILOT_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "sim/controller.hpp"
+
+namespace snake {
+namespace sim {
+
+/**
+ * Steers the snake along a Hamiltonian cycle of the playable area, cutting
+ * across the cycle toward the target whenever that is safe.
+ *
+ * The snake's Tiles always lie, tail to head, in cycle order within the
+ * stretch of the cycle running from the tail forward to the head. Following
+ * the cycle from the head therefore only ever visits free Tiles or the Tile
+ * the tail is about to leave, so the snake can never die. A shortcut skips
+ * ahead along the cycle to a neighbouring free Tile which lies before both
+ * the tail and the target, which keeps that invariant. Every decision looks at
+ * the four neighbours of the head only, so its cost is independent of the
+ * board size.
+ *
+ * If both playable dimensions are odd the board has no Hamiltonian cycle and
+ * the cycle leaves out a corner Tile. Should the target spawn there the snake
+ * takes a detour through the corner and the cycle is rerouted around the
+ * corner's neighbour instead. If either playable dimension is one Tile the
+ * board has no cycle either and the autopilot falls back to the
+ * GreedyController.
+ *
+ * The cycle is rebuilt should the game be resized, see
+ * snake::game::SnakeGame::Resize(). The snake then no longer lies in cycle
+ * order in general and is steered by the GreedyController, which can lose,
+ * until it does again.
+ */
+class AutopilotController : public Controller {
+   public:
+    void NewGame(const snake::game::SnakeGame& game,
+                 std::uint64_t seed) override;
+    snake::game::Direction NextDirection(
+        const snake::game::SnakeGame& game) override;
+
+   private:
+    static constexpr int kNotOnCycle = -1;
+
+    /** Build the cycle for the board of the parameter game. */
+    void BuildCycle(const snake::game::SnakeGame& game);
+
+    /**
+     * Return true if the snake's Tiles lie, tail to head, in cycle order
+     * within the stretch of the cycle running from the tail to the head.
+     */
+    bool IsInCycleOrder(const snake::game::Snake& snake) const;
+
+    /** Append the Tile at the parameter row and column to the cycle. */
+    void AppendToCycle(int row, int col);
+
+    /** Return how many steps along the cycle lead from one Tile to another. */
+    int CycleDistance(int from, int to) const {
+        int distance = cycle_index_[to] - cycle_index_[from];
+        return (distance < 0) ? (distance + NumCycleTiles()) : distance;
+    }
+
+    int NumCycleTiles() const { return static_cast<int>(cycle_.size()); }
+
+    int CellIndex(const snake::game::Tile& tile) const {
+        return tile.row * screen_dim_.width + tile.col;
+    }
+
+    /** Exchange the corner Tile left out of the cycle and its detour. */
+    void SwapCorner();
+
+    snake::game::ScreenDimension screen_dim_;
+    int border_ = 0;
+    std::vector<int> cycle_;       /**< Cells in cycle order. */
+    std::vector<int> cycle_index_; /**< Position of each cell in cycle_ or
+                                        kNotOnCycle. */
+
+    /* on odd by odd boards the corner left out of the cycle, the cycle Tile
+     * adjacent to it from which the detour starts and the cycle Tile the
+     * corner replaces when the detour is taken */
+    int corner_ = kNotOnCycle;
+    int corner_entry_ = kNotOnCycle;
+    int corner_swap_ = kNotOnCycle;
+
+    bool in_cycle_order_ = true; /**< False after a resize until the snake
+                                      lies in cycle order again. */
+
+    GreedyController fallback_;
+};
+
+}  // namespace sim
+}  // namespace snake
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef CONTROLLER_HPP_
+#define CONTROLLER_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "game/game.hpp"
+#include "path/path_cache.hpp"
+
+namespace snake {
+namespace sim {
+
+/**
+ * Policy which decides the direction the snake moves in each game tick.
+ *
+ * Controllers are driven by a Runner and never see a terminal. A single
+ * controller instance is reused across every game of a run.
+ */
+class Controller {
+   public:
+    virtual ~Controller() = default;
+
+    /**
+     * Called after the parameter game has been reset for a new game.
+     *
+     * @param[in] game The freshly reset game.
+     * @param[in] seed Seed for any randomness the controller uses during this
+     *                 game so that runs are reproducible.
+     */
+    virtual void NewGame(const snake::game::SnakeGame& game,
+                         std::uint64_t seed) {
+        (void)game;
+        (void)seed;
+    }
+
+    /** Return the direction to pass to the next SnakeGame::Tick() call. */
+    virtual snake::game::Direction NextDirection(
+        const snake::game::SnakeGame& game) = 0;
+};
+
+/** Moves in a uniformly random direction that does not reverse the snake. */
+class RandomController : public Controller {
+   public:
+    void NewGame(const snake::game::SnakeGame& game,
+                 std::uint64_t seed) override;
+    snake::game::Direction NextDirection(
+        const snake::game::SnakeGame& game) override;
+
+   private:
+    snake::game::Rng rng_;
+};
+
+/**
+ * Moves toward the target along whichever axis closes the distance, avoiding
+ * any move that would end the game on the next tick when possible.
+ */
+class GreedyController : public Controller {
+   public:
+    snake::game::Direction NextDirection(
+        const snake::game::SnakeGame& game) override;
+};
+
+/**
+ * Follows a shortest path to the target, which is only planned again when the
+ * target moves or the path is blocked, see snake::path::PathCache. Moves like
+ * the GreedyController while the target cannot be reached.
+ */
+class PathController : public Controller {
+   public:
+    void NewGame(const snake::game::SnakeGame& game,
+                 std::uint64_t seed) override;
+    snake::game::Direction NextDirection(
+        const snake::game::SnakeGame& game) override;
+
+    const snake::path::PathCache& GetPathCache() const { return path_; }
+
+   private:
+    snake::path::PathCache path_;
+    GreedyController fallback_;
+};
+
+/** Callable returning a new controller, invoked once per worker thread. */
+using ControllerFactory = std::function<std::unique_ptr<Controller>()>;
+
+/**
+ * Construct the controller with the parameter name.
+ *
+ * @param[in] name One of "random", "greedy", "path" or "autopilot".
+ * @returns The controller or nullptr if the name is unknown.
+ */
+std::unique_ptr<Controller> MakeController(const std::string& name);
+
+}  // namespace sim
+}  // namespace snake
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef RUNNER_HPP_
+#define RUNNER_HPP_
+
+#include <cstdint>
+#include <map>
+
+#include "game/game.hpp"
+#include "sim/controller.hpp"
+
+namespace snake {
+namespace sim {
+
+struct RunConfig {
+    snake::game::ScreenDimension dim; /**< Board size including the border. */
+    std::int64_t num_games = 1;       /**< Number of games to play. */
+    std::int64_t max_ticks = 0;       /**< Per game tick limit, 0 for none. */
+    std::uint64_t seed = 0;           /**< Base seed of the whole run. */
+    int num_threads = 1;              /**< Worker threads for parallel runs. */
+};
+
+struct RunStats {
+    std::int64_t games = 0;    /**< Number of games played. */
+    std::int64_t ticks = 0;    /**< Total ticks across all games. */
+    std::int64_t wins = 0;     /**< Games in which the snake filled the
+                                    board. */
+    std::int64_t timeouts = 0; /**< Games stopped at the tick limit. */
+    double elapsed_sec = 0.0;  /**< Wall time spent playing. */
+
+    std::map<int, std::int64_t> scores;  /**< Final score to game count. */
+    std::map<int, std::int64_t> lengths; /**< Final length to game count. */
+
+    /** Accumulate the parameter stats into this object. */
+    void Merge(const RunStats& other);
+};
+
+/**
+ * Play games back to back without rendering.
+ *
+ * A single SnakeGame, allocated from an arena of its own, is reset between
+ * games so that steady state play does not allocate. Game i of the run is
+ * seeded from the run's base seed and i alone, so the same config always
+ * produces the same statistics.
+ *
+ * @param[in] config Board size, number of games to play and base seed.
+ * @param[in] controller Policy deciding the snake's direction every tick.
+ * @returns Aggregate statistics over all games played.
+ */
+RunStats RunGames(const RunConfig& config, Controller& controller);
+
+/**
+ * Play games on config.num_threads worker threads.
+ *
+ * Every worker owns its own SnakeGame, kept in a per thread arena, controller
+ * and statistics. Game indices
+ * are split evenly between workers up front and idle workers steal half of the
+ * remaining games of a busy worker. Because each game's seed depends only on
+ * its index, the returned statistics (except for elapsed time) are identical
+ * to RunGames() for any number of threads.
+ *
+ * @param[in] config Board size, number of games (at most 2^32 - 1), base seed
+ *                   and thread count.
+ * @param[in] make_controller Factory invoked once per worker thread.
+ * @returns Aggregate statistics over all games played.
+ */
+RunStats RunGamesParallel(const RunConfig& config,
+                          const ControllerFactory& make_controller);
+
+}  // namespace sim
+}  // namespace snake
+
+#endif
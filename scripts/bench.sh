@@ -0,0 +1,12 @@
+#!/bin/bash
+
+source config.sh
+
+# Results are written as JSON so that runs can be compared over time.
+BENCH_OUT="${1:-${SNAKE_BIN_DIR}/snake_bench.json}"
+
+pushd $SNAKE_BIN_DIR > /dev/null
+    ./snake_bench \
+        --benchmark_out="$BENCH_OUT" \
+        --benchmark_out_format=json
+popd > /dev/null
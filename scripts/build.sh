@@ -1,6 +1,7 @@
 #!/bin/bash
 
 BUILD_TYPE="Release"
+METRICS="OFF"
 
 source config.sh
 
@@ -11,6 +12,7 @@ Help()
     echo "usage: build.sh [OPTION]..."
     echo "options:"
     echo -e "\tg    enable debug info"
+    echo -e "\tm    enable the instrumentation hooks"
     echo -e "\th    print this help message"
 }
 
@@ -22,7 +24,8 @@ Main()
     pushd $SNAKE_BUILD_DIR > /dev/null
         cmake ../ \
               -DCMAKE_EXPORT_COMPILE_COMMANDS=ON \
-              -DCMAKE_BUILD_TYPE=$BUILD_TYPE && \
+              -DCMAKE_BUILD_TYPE=$BUILD_TYPE \
+              -DSNAKE_METRICS=$METRICS && \
         make -j$(nproc) all                  && \
         make install
 
@@ -34,10 +37,11 @@ Main()
     popd > /dev/null
 }
 
-while getopts ":hg" flag
+while getopts ":hgm" flag
 do
     case "$flag" in
         g) BUILD_TYPE="Debug";;
+        m) METRICS="ON";;
         h) Help
            exit;;
        \?) echo "error: invalid option '$OPTARG'"
@@ -0,0 +1,303 @@
+#include "game/env.hpp"
+
+#include <algorithm>
+
+#include "game/rng.hpp"
+
+namespace snake {
+namespace game {
+
+/* the encoders are written once against these two views of a single game */
+namespace {
+
+class GameView {
+   public:
+    explicit GameView(const SnakeGame& game) : game_(game) {}
+
+    ScreenDimension GetScreenDimension() const {
+        return game_.GetScreenDimension();
+    }
+    int GetBorder() const { return game_.GetBorder(); }
+    std::size_t GetLength() const { return game_.GetSnake().size(); }
+    Tile GetSnakeTile(std::size_t i) const { return game_.GetSnake()[i]; }
+    Tile GetTargetTile() const { return game_.GetTargetTile(); }
+    bool IsFree(const Tile& tile) const { return game_.IsFree(tile); }
+
+   private:
+    const SnakeGame& game_;
+};
+
+class BatchView {
+   public:
+    BatchView(const SnakeGameBatch& batch, std::size_t game)
+        : batch_(batch), game_(game) {}
+
+    ScreenDimension GetScreenDimension() const {
+        return batch_.GetScreenDimension();
+    }
+    int GetBorder() const { return batch_.GetBorder(); }
+    std::size_t GetLength() const { return batch_.GetLength(game_); }
+    Tile GetSnakeTile(std::size_t i) const {
+        return batch_.GetSnakeTile(game_, i);
+    }
+    Tile GetTargetTile() const { return batch_.GetTargetTile(game_); }
+    bool IsFree(const Tile& tile) const { return batch_.IsFree(game_, tile); }
+
+   private:
+    const SnakeGameBatch& batch_;
+    std::size_t game_;
+};
+
+}  // namespace
+
+std::size_t GetObservationSize(Observation observation,
+                               const ScreenDimension& dim, int border) {
+    switch (observation) {
+        case Observation::kGrid:
+            return kGridChannels *
+                   static_cast<std::size_t>((dim.width - 2 * border) *
+                                            (dim.height - 2 * border));
+        case Observation::kFeatures:
+            return kNumFeatures;
+        case Observation::kRays:
+            return kNumRays * kRayValues;
+    }
+    return 0;
+}
+
+template <typename View>
+static bool IsInBounds(const View& view, const Tile& tile) {
+    const ScreenDimension kDim = view.GetScreenDimension();
+    const int kBorder = view.GetBorder();
+    return (tile.row >= kBorder) && (tile.row < (kDim.height - kBorder)) &&
+           (tile.col >= kBorder) && (tile.col < (kDim.width - kBorder));
+}
+
+template <typename View>
+static void EncodeGrid(const View& view, float* out) {
+    const ScreenDimension kDim = view.GetScreenDimension();
+    const int kBorder = view.GetBorder();
+    const int kWidth = kDim.width - 2 * kBorder;
+    const std::size_t kChannelSize =
+        static_cast<std::size_t>(kWidth * (kDim.height - 2 * kBorder));
+    float* body = out;
+    float* head = out + kChannelSize;
+    float* target = out + 2 * kChannelSize;
+    std::fill(out, out + kGridChannels * kChannelSize, 0.0F);
+
+    auto offset = [&](const Tile& tile) {
+        return static_cast<std::size_t>((tile.row - kBorder) * kWidth +
+                                        (tile.col - kBorder));
+    };
+
+    /* the head has left the board once the snake hit the border */
+    const Tile kHead = view.GetSnakeTile(0);
+    if (IsInBounds(view, kHead)) {
+        head[offset(kHead)] = 1.0F;
+    }
+    for (std::size_t i = 1; i < view.GetLength(); ++i) {
+        body[offset(view.GetSnakeTile(i))] = 1.0F;
+    }
+    target[offset(view.GetTargetTile())] = 1.0F;
+}
+
+static Direction TurnLeft(Direction direction) {
+    switch (direction) {
+        case Direction::kUp:
+            return Direction::kLeft;
+        case Direction::kLeft:
+            return Direction::kDown;
+        case Direction::kDown:
+            return Direction::kRight;
+        case Direction::kRight:
+            return Direction::kUp;
+        case Direction::kNone:
+            break;
+    }
+    return Direction::kNone;
+}
+
+template <typename View>
+static void EncodeFeatures(const View& view, float* out) {
+    const Tile kHead = view.GetSnakeTile(0);
+    const Tile kTarget = view.GetTargetTile();
+    const Direction kAhead = kHead.direction;
+    const Direction kLeft = TurnLeft(kAhead);
+    const Direction kRight = Opposite(kLeft);
+
+    /* the tail counts as blocked, see SnakeGame::IsFree() */
+    *out++ = !view.IsFree(Neighbor(kHead, kAhead));
+    *out++ = !view.IsFree(Neighbor(kHead, kLeft));
+    *out++ = !view.IsFree(Neighbor(kHead, kRight));
+
+    *out++ = (Direction::kUp == kAhead);
+    *out++ = (Direction::kDown == kAhead);
+    *out++ = (Direction::kLeft == kAhead);
+    *out++ = (Direction::kRight == kAhead);
+
+    *out++ = (kTarget.row < kHead.row);
+    *out++ = (kTarget.row > kHead.row);
+    *out++ = (kTarget.col < kHead.col);
+    *out++ = (kTarget.col > kHead.col);
+}
+
+template <typename View>
+static void EncodeRays(const View& view, float* out) {
+    /* row and column steps of the rays, clockwise starting straight up */
+    const int kSteps[kNumRays][2] = {{-1, 0}, {-1, 1}, {0, 1},  {1, 1},
+                                     {1, 0},  {1, -1}, {0, -1}, {-1, -1}};
+    const Tile kHead = view.GetSnakeTile(0);
+    const Tile kTarget = view.GetTargetTile();
+    for (const auto& step : kSteps) {
+        float body = 0.0F;
+        float target = 0.0F;
+        Tile tile = kHead;
+        int distance = 1;
+        for (;; ++distance) {
+            tile.row += step[0];
+            tile.col += step[1];
+            if (!IsInBounds(view, tile)) {
+                break;
+            }
+            if ((0.0F == body) && !view.IsFree(tile)) {
+                body = 1.0F / static_cast<float>(distance);
+            }
+            if (tile == kTarget) {
+                target = 1.0F;
+            }
+        }
+        *out++ = 1.0F / static_cast<float>(distance);
+        *out++ = body;
+        *out++ = target;
+    }
+}
+
+template <typename View>
+static void Encode(Observation observation, const View& view, float* out) {
+    switch (observation) {
+        case Observation::kGrid:
+            EncodeGrid(view, out);
+            break;
+        case Observation::kFeatures:
+            EncodeFeatures(view, out);
+            break;
+        case Observation::kRays:
+            EncodeRays(view, out);
+            break;
+    }
+}
+
+void EncodeObservation(Observation observation, const SnakeGame& game,
+                       float* out) {
+    Encode(observation, GameView(game), out);
+}
+
+void EncodeObservation(Observation observation, const SnakeGameBatch& batch,
+                       std::size_t game, float* out) {
+    Encode(observation, BatchView(batch, game), out);
+}
+
+/** Return the reward for a tick which changed the score by score_delta. */
+static float GetReward(const EnvConfig& config, int score_delta,
+                       bool lost) {
+    float reward = config.tick_reward;
+    if (score_delta > 0) {
+        reward += config.target_reward;
+    }
+    if (lost) {
+        reward += config.death_reward;
+    }
+    return reward;
+}
+
+SnakeEnv::SnakeEnv(const EnvConfig& config)
+    : config_(config), game_(config.dim, config.border, Rng(0)) {
+    Reset(0);
+}
+
+void SnakeEnv::Reset(std::uint64_t seed) {
+    game_.Reset(seed);
+    idle_ticks_ = 0;
+    done_ = false;
+}
+
+StepResult SnakeEnv::Step(Direction action) {
+    if (done_) {
+        return {.reward = 0.0F, .done = true, .truncated = false};
+    }
+
+    const int kPrevScore = game_.GetScore();
+    game_.Tick(action);
+    const int kScoreDelta = game_.GetScore() - kPrevScore;
+    idle_ticks_ = (kScoreDelta > 0) ? 0 : (idle_ticks_ + 1);
+
+    StepResult result = {
+        .reward = GetReward(config_, kScoreDelta,
+                            game_.GameOver() && !game_.SnakeWins()),
+        .done = game_.GameOver(),
+        .truncated = false};
+    if (!result.done && (config_.max_idle_ticks > 0) &&
+        (idle_ticks_ >= config_.max_idle_ticks)) {
+        result.done = true;
+        result.truncated = true;
+    }
+    done_ = result.done;
+    return result;
+}
+
+SnakeVecEnv::SnakeVecEnv(const EnvConfig& config, std::size_t num_envs)
+    : config_(config),
+      batch_(config.dim, num_envs, config.border),
+      scores_(num_envs),
+      idle_ticks_(num_envs) {
+    Reset(0);
+}
+
+void SnakeVecEnv::StartEpisode(std::size_t env) {
+    batch_.Reset(env, SplitMix64(seed_ + next_episode_));
+    next_episode_++;
+    idle_ticks_[env] = 0;
+}
+
+void SnakeVecEnv::Reset(std::uint64_t seed) {
+    seed_ = seed;
+    next_episode_ = 0;
+    for (std::size_t i = 0; i < Size(); ++i) {
+        StartEpisode(i);
+    }
+}
+
+void SnakeVecEnv::Step(const Direction* actions, float* rewards,
+                       std::uint8_t* dones) {
+    for (std::size_t i = 0; i < Size(); ++i) {
+        scores_[i] = batch_.GetScore(i);
+    }
+    batch_.Tick(actions);
+
+    for (std::size_t i = 0; i < Size(); ++i) {
+        const int kScoreDelta = batch_.GetScore(i) - scores_[i];
+        idle_ticks_[i] = (kScoreDelta > 0) ? 0 : (idle_ticks_[i] + 1);
+
+        const bool kGameOver = batch_.GameOver(i);
+        rewards[i] = GetReward(config_, kScoreDelta,
+                               kGameOver && !batch_.SnakeWins(i));
+        dones[i] = kGameOver ? 1 : 0;
+        if (!kGameOver && (config_.max_idle_ticks > 0) &&
+            (idle_ticks_[i] >= config_.max_idle_ticks)) {
+            dones[i] = 2;
+        }
+        if (dones[i]) {
+            StartEpisode(i);
+        }
+    }
+}
+
+void SnakeVecEnv::Observe(Observation observation, float* out) const {
+    const std::size_t kSize = GetObservationSize(observation);
+    for (std::size_t i = 0; i < Size(); ++i) {
+        EncodeObservation(observation, batch_, i, out + i * kSize);
+    }
+}
+
+}  // namespace game
+}  // namespace snake
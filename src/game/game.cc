@@ -7,172 +7,500 @@
 namespace snake {
 namespace game {
 
-void SnakeGame::SpawnSnake() {
-    /* create a random shuffle of the possible directions the snake can go */
-    std::vector<Direction> directions = {Direction::kUp, Direction::kDown,
-                                         Direction::kLeft, Direction::kRight};
-    auto rd = std::random_device{};
-    auto rng = std::default_random_engine{rd()};
-    std::shuffle(directions.begin(), directions.end(), rng);
-
-    /* spawn the snake head in the center of the screen with a random direction
-     */
-    snake_.push_back({.row = screen_dim_.height / 2,
-                      .col = screen_dim_.width / 2,
-                      .direction = directions[0]});
-}
-
-void SnakeGame::MoveSnake(const Direction& new_direction) {
-    /* shift all but the head tiles into their predecessor's position */
-    Snake tmp = snake_;
-    for (std::size_t i = 1; i < snake_.size(); ++i) {
-        snake_[i] = tmp[i - 1];
-    }
-
-    /* walk the head forward in whatever direction it's facing */
-    Tile& head = snake_.front();
-    head.direction = new_direction;
-    switch (snake_.front().direction) {
+Tile Neighbor(const Tile& tile, const Direction& direction) {
+    Tile neighbor = tile;
+    switch (direction) {
         case Direction::kUp:
-            head.row--;
+            neighbor.row--;
             break;
         case Direction::kDown:
-            head.row++;
+            neighbor.row++;
             break;
         case Direction::kLeft:
-            head.col--;
+            neighbor.col--;
             break;
         case Direction::kRight:
-            head.col++;
+            neighbor.col++;
             break;
         case Direction::kNone:
             break;
     }
+    return neighbor;
 }
 
-void SnakeGame::ExtendSnake() {
-    Tile new_snake_tile = snake_.back();
-
-    /* the new tile's location is the current snake tail's location shifted
-     * opposite the snake tail's direction */
-    switch (new_snake_tile.direction) {
+Direction Opposite(const Direction& direction) {
+    switch (direction) {
         case Direction::kUp:
-            new_snake_tile.row++;
-            break;
+            return Direction::kDown;
         case Direction::kDown:
-            new_snake_tile.row--;
-            break;
+            return Direction::kUp;
         case Direction::kLeft:
-            new_snake_tile.col++;
-            break;
+            return Direction::kRight;
         case Direction::kRight:
-            new_snake_tile.col--;
-            break;
+            return Direction::kLeft;
         case Direction::kNone:
             break;
     }
-    snake_.push_back(new_snake_tile);
+    return Direction::kNone;
 }
 
-bool SnakeGame::IsGameOver() const {
-    /* check if the snake overlaps itself at any tile */
-    for (std::size_t i = 0; i < snake_.size(); ++i) {
-        for (std::size_t j = i + 1; j < snake_.size(); ++j) {
-            if (snake_[i] == snake_[j]) {
-                return true;
-            }
-        }
-    }
+void SnakeGame::SpawnSnake() {
+    /* pick one of the possible directions the snake can go at random */
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    Direction direction = kDirections[rng_.Below(4)];
 
-    /* verify the head snake tile is in bounds */
+    /* spawn the snake head in the center of the screen with a random direction
+     */
+    snake_.push_back({.row = screen_dim_.height / 2,
+                      .col = screen_dim_.width / 2,
+                      .direction = direction});
+}
+
+void SnakeGame::MoveSnake(const Direction& new_direction) {
+    /* walk the head forward in the new direction, the previous head stays put
+     * and becomes the first body tile */
+    const Tile kPrevHead = snake_.front();
+    const Tile kTail = snake_.back();
+    Tile head = Neighbor(kPrevHead, new_direction);
+    head.direction = new_direction;
+
+    last_delta_.prev_head = kPrevHead;
+    last_delta_.head = head;
+    last_delta_.vacated_tail = kTail;
+    last_delta_.tail_vacated = true;
+    last_delta_.target_moved = false;
+
+    /* the tail vacates its tile before the head moves so the head may follow
+     * directly behind it */
+    VacateCell(CellIndex(kTail));
+    snake_.pop_back();
+
+    snake_.push_front(head);
+}
+
+int SnakeGame::ExtendSnake() {
+    /* the new tile's location is the current snake tail's location shifted
+     * opposite the snake tail's direction */
+    const Tile kTail = snake_.back();
+    Tile new_snake_tile = Neighbor(kTail, Opposite(kTail.direction));
+
+    snake_.push_back(new_snake_tile);
+
+    /* the new tile always fills the tile the tail vacated during this tick */
+    last_delta_.tail_vacated = false;
+
+    return OccupyCell(CellIndex(new_snake_tile));
+}
+
+bool SnakeGame::IsInBounds(const Tile& tile) const {
     bool is_in_row_bounds =
-        (snake_.front().row >= border_) &&
-        (snake_.front().row < (screen_dim_.height - border_));
+        (tile.row >= border_) && (tile.row < (screen_dim_.height - border_));
     bool is_in_col_bounds =
-        (snake_.front().col >= border_) &&
-        (snake_.front().col < (screen_dim_.width - border_));
+        (tile.col >= border_) && (tile.col < (screen_dim_.width - border_));
 
-    return (!is_in_row_bounds || !is_in_col_bounds);
+    return (is_in_row_bounds && is_in_col_bounds);
+}
+
+bool SnakeGame::IsGameOver() const {
+    /* verify the head snake tile is in bounds */
+    const Tile& head = snake_.front();
+    if (!IsInBounds(head)) {
+        return true;
+    }
+
+    /* the body tiles never overlap one another so the snake can only overlap
+     * itself at the head which has not yet been marked in the occupancy grid */
+    return occupied_[CellIndex(head)];
 }
 
 bool SnakeGame::SnakeWins() const {
-    /* check whether the snake is occupying every possible target location */
-    for (const Tile& target_tile : targets_) {
-        bool found = false;
-        for (const Tile& snake_tile : snake_) {
-            if (snake_tile == target_tile) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) { /* looks like there's at least one open target location */
-            return false;
+    /* the snake has won once there is nowhere left to place a target */
+    return free_cells_.empty();
+}
+
+void SnakeGame::SpawnTarget() {
+    int cell = free_cells_[rng_.Below(
+        static_cast<std::uint32_t>(free_cells_.size()))];
+    curr_target_ = {.row = cell / screen_dim_.width,
+                    .col = cell % screen_dim_.width,
+                    .direction = Direction::kNone};
+}
+
+int SnakeGame::OccupyCell(int cell) {
+    /* swap the cell with the last free cell and drop it from the free set */
+    int pos = free_index_[cell];
+    int last = free_cells_.back();
+    free_cells_[pos] = last;
+    free_index_[last] = pos;
+    free_cells_.pop_back();
+    free_index_[cell] = kNotFree;
+
+    occupied_[cell] = true;
+
+    return pos;
+}
+
+void SnakeGame::VacateCell(int cell) {
+    free_index_[cell] = static_cast<int>(free_cells_.size());
+    free_cells_.push_back(cell);
+
+    occupied_[cell] = false;
+}
+
+void SnakeGame::UnoccupyCell(int cell, int pos) {
+    /* put the cell back at its old position and the cell which was swapped
+     * into that position back at the end */
+    const auto kEnd = static_cast<int>(free_cells_.size());
+    if (pos != kEnd) {
+        int moved = free_cells_[pos];
+        free_index_[moved] = kEnd;
+        free_cells_.push_back(moved);
+        free_cells_[pos] = cell;
+    } else {
+        free_cells_.push_back(cell);
+    }
+    free_index_[cell] = pos;
+
+    occupied_[cell] = false;
+}
+
+void SnakeGame::UnvacateCell(int cell) {
+    free_cells_.pop_back();
+    free_index_[cell] = kNotFree;
+
+    occupied_[cell] = true;
+}
+
+void SnakeGame::RemoveSnake() {
+    /* a head which ended the game out of bounds or on top of the body was
+     * never marked */
+    for (const Tile& tile : snake_) {
+        if (IsInBounds(tile) && occupied_[CellIndex(tile)]) {
+            VacateCell(CellIndex(tile));
         }
     }
-    return true;
+    snake_.clear();
 }
 
 SnakeGame::SnakeGame(const ScreenDimension& dim, int border)
+    : SnakeGame(dim, border, Rng(std::random_device{}())) {}
+
+SnakeGame::SnakeGame(const ScreenDimension& dim, int border, const Rng& rng,
+                     std::pmr::memory_resource* resource)
     : game_over_(false),
       score_(0),
+      ticks_(0),
       border_(border),
       screen_dim_(dim),
-      curr_target_(0) {
+      snake_(resource),
+      occupied_(resource),
+      free_cells_(resource),
+      free_index_(resource),
+      rng_(rng),
+      undo_(resource) {
+    /* the snake can grow at most as long as there are playable tiles, the
+     * free set is reserved up front so that filling it allocates once */
+    const auto kNumPlayable = static_cast<std::size_t>(
+        (dim.width - 2 * border) * (dim.height - 2 * border));
+    free_cells_.reserve(kNumPlayable);
+    snake_.Reset(kNumPlayable);
+    ClearBoard();
+
     Reset();
 }
 
+std::size_t SnakeGame::GetStorageSize(const ScreenDimension& dim, int border) {
+    const auto kNumCells = static_cast<std::size_t>(dim.width * dim.height);
+    const auto kNumPlayable = static_cast<std::size_t>(
+        (dim.width - 2 * border) * (dim.height - 2 * border));
+
+    /* the occupancy bits are stored in words, leave room to align each of the
+     * five blocks */
+    const std::size_t kWordBits = 8 * sizeof(unsigned long);
+    return ((kNumCells + kWordBits - 1) / kWordBits) * sizeof(unsigned long) +
+           kNumPlayable * sizeof(int) + kNumCells * sizeof(int) +
+           Snake::GetStorageSize(kNumPlayable) +
+           5 * alignof(std::max_align_t);
+}
+
+void SnakeGame::ClearBoard() {
+    /* every playable tile starts out free, listed in row major order */
+    const auto kNumCells =
+        static_cast<std::size_t>(screen_dim_.width * screen_dim_.height);
+    occupied_.assign(kNumCells, false);
+    free_index_.assign(kNumCells, kNotFree);
+    ListFreeCells();
+    snake_.clear();
+}
+
+void SnakeGame::ListFreeCells() {
+    free_cells_.clear();
+    for (int i = border_; i < (screen_dim_.height - border_); ++i) {
+        for (int j = border_; j < (screen_dim_.width - border_); ++j) {
+            int cell = CellIndex({.row = i, .col = j});
+            if (!occupied_[cell]) {
+                free_index_[cell] = static_cast<int>(free_cells_.size());
+                free_cells_.push_back(cell);
+            }
+        }
+    }
+}
+
+std::pair<Tile, Tile> SnakeGame::GetSnakeBounds() const {
+    Tile top_left = snake_.front();
+    Tile bottom_right = top_left;
+    for (const Tile& tile : snake_) {
+        top_left.row = std::min(top_left.row, tile.row);
+        top_left.col = std::min(top_left.col, tile.col);
+        bottom_right.row = std::max(bottom_right.row, tile.row);
+        bottom_right.col = std::max(bottom_right.col, tile.col);
+    }
+    return {top_left, bottom_right};
+}
+
 void SnakeGame::Tick(const Direction& new_direction) {
-    MoveSnake(new_direction);
+    if (game_over_) { /* do nothing if the game has already ended */
+        return;
+    }
+
+    /* save whatever the tick is about to overwrite */
+    TickUndo* undo = nullptr;
+    if (undo_enabled_) {
+        undo = &undo_.emplace_back();
+        undo->tail = snake_.back();
+        undo->target = curr_target_;
+        undo->last_delta = last_delta_;
+        undo->rng = rng_;
+        undo->score = score_;
+    }
 
-    if (IsGameOver()) { /* do nothing if the game has already ended */
+    /* the snake never stands still, a Tile's direction is always one it can
+     * move in */
+    MoveSnake((Direction::kNone == new_direction) ? snake_.front().direction
+                                                  : new_direction);
+    ticks_++;
+
+    if (IsGameOver()) {
         game_over_ = true;
         return;
     }
+    const Tile& head = last_delta_.head;
+    int head_pos = OccupyCell(CellIndex(head));
+    if (undo) {
+        undo->head_pos = head_pos;
+    }
 
     /* looks like the snake ate its target */
-    if (snake_[0] == targets_[curr_target_]) {
+    if (head == curr_target_) {
         score_ += kScoreIncrement;
 
-        ExtendSnake();
+        int grow_pos = ExtendSnake();
+        if (undo) {
+            undo->grow_pos = grow_pos;
+        }
 
         if (SnakeWins()) {
             game_over_ = true;
             return;
         }
 
-        /* search for the next target tile that is not occupied by the snake */
-        while (std::find(snake_.begin(), snake_.end(),
-                         targets_[curr_target_]) != snake_.end()) {
-            curr_target_ =
-                (curr_target_ + 1) % static_cast<int>(targets_.size());
-        }
+        SpawnTarget();
+        last_delta_.target_moved = true;
     }
 }
 
 void SnakeGame::Reset() {
     game_over_ = false;
     score_ = 0;
+    ticks_ = 0;
+    last_delta_ = {};
+    undo_.clear();
 
-    /* generate a randomly shuffled vector of potential target locations */
-    targets_.clear();
-    for (int i = border_; i < (screen_dim_.height - border_); ++i) {
-        for (int j = border_; j < (screen_dim_.width - border_); ++j) {
-            targets_.push_back(
-                {.row = i, .col = j, .direction = Direction::kNone});
+    /* respawn the snake */
+    RemoveSnake();
+    SpawnSnake();
+    OccupyCell(CellIndex(snake_.front()));
+
+    /* the head alone fills a board of a single playable tile, which is won
+     * from the start and leaves the target on the head as any other win */
+    if (SnakeWins()) {
+        curr_target_ = {.row = snake_.front().row,
+                        .col = snake_.front().col,
+                        .direction = Direction::kNone};
+        game_over_ = true;
+        return;
+    }
+
+    /* the target can only spawn on a tile the snake head does not occupy */
+    SpawnTarget();
+}
+
+void SnakeGame::Reset(std::uint64_t seed) {
+    /* the order of the free cells depends on every game played before, start
+     * from the initial order so the new game depends on the seed alone */
+    rng_.Seed(seed);
+    ClearBoard();
+    Reset();
+}
+
+ScreenDimension SnakeGame::GetMinScreenDimension() const {
+    const auto [kTopLeft, kBottomRight] = GetSnakeBounds();
+    ScreenDimension dim = {
+        .width = kBottomRight.col - kTopLeft.col + 1 + 2 * border_,
+        .height = kBottomRight.row - kTopLeft.row + 1 + 2 * border_};
+
+    /* a snake filling its whole bounding box needs one more column for the
+     * target */
+    const auto kBoxTiles = static_cast<std::size_t>(
+        (dim.width - 2 * border_) * (dim.height - 2 * border_));
+    if (snake_.size() == kBoxTiles) {
+        dim.width++;
+    }
+    return dim;
+}
+
+/**
+ * Return the smallest shift which moves the span [lo, hi] within [min, end).
+ *
+ * The span must be no longer than the range.
+ */
+static int ShiftInto(int lo, int hi, int min, int end) {
+    if (lo < min) {
+        return (min - lo);
+    }
+    if (hi >= end) {
+        return (end - 1 - hi);
+    }
+    return 0;
+}
+
+bool SnakeGame::Resize(const ScreenDimension& dim) {
+    const ScreenDimension kMinDim = GetMinScreenDimension();
+    if (game_over_ || (dim.width < kMinDim.width) ||
+        (dim.height < kMinDim.height) || (dim.width > kMaxPackedCoordinate) ||
+        (dim.height > kMaxPackedCoordinate)) {
+        return false;
+    }
+    if ((dim.width == screen_dim_.width) &&
+        (dim.height == screen_dim_.height)) {
+        return true;
+    }
+
+    /* shift the snake by the least needed to bring it within the new
+     * border, the target moving along so that the two keep their places
+     * relative to each other */
+    const auto [kTopLeft, kBottomRight] = GetSnakeBounds();
+    const int kRowShift = ShiftInto(kTopLeft.row, kBottomRight.row, border_,
+                                    dim.height - border_);
+    const int kColShift = ShiftInto(kTopLeft.col, kBottomRight.col, border_,
+                                    dim.width - border_);
+    const auto kNumTiles = static_cast<std::size_t>(
+        (dim.width - 2 * border_) * (dim.height - 2 * border_));
+    snake_.Grow(kNumTiles);
+    free_cells_.reserve(kNumTiles);
+    if ((0 != kRowShift) || (0 != kColShift)) {
+        for (std::size_t i = 0; i < snake_.size(); ++i) {
+            Tile tile = snake_.front();
+            snake_.pop_front();
+            tile.row += kRowShift;
+            tile.col += kColShift;
+            snake_.push_back(tile);
         }
+        curr_target_.row += kRowShift;
+        curr_target_.col += kColShift;
     }
-    auto rd = std::random_device{};
-    auto rng = std::default_random_engine{rd()};
-    std::shuffle(targets_.begin(), targets_.end(), rng);
-    curr_target_ = 0;
 
-    /* respawn the snake */
-    snake_.clear();
-    SpawnSnake();
+    /* rebuild the board in one pass over the new screen */
+    screen_dim_ = dim;
+    const auto kNumCells =
+        static_cast<std::size_t>(screen_dim_.width * screen_dim_.height);
+    occupied_.assign(kNumCells, false);
+    for (const Tile& tile : snake_) {
+        occupied_[CellIndex(tile)] = true;
+    }
+    free_index_.assign(kNumCells, kNotFree);
+    ListFreeCells();
+
+    if (!IsFree(curr_target_)) {
+        SpawnTarget();
+    }
+    last_delta_ = {};
+    undo_.clear();
+
+    return true;
+}
+
+void SnakeGame::SaveState(GameState& state) const {
+    state.snake.resize(snake_.size());
+    snake_.CopyTo(state.snake.data());
+    state.target = curr_target_;
+    state.last_delta = last_delta_;
+    state.rng = rng_;
+    state.score = score_;
+    state.ticks = ticks_;
+    state.game_over = game_over_;
+}
+
+void SnakeGame::RestoreState(const GameState& state) {
+    RemoveSnake();
+    for (const Tile& tile : state.snake) {
+        snake_.push_back(tile);
+
+        /* skip a head which ended the game, see RemoveSnake() */
+        if (IsInBounds(tile) && !occupied_[CellIndex(tile)]) {
+            OccupyCell(CellIndex(tile));
+        }
+    }
+
+    curr_target_ = state.target;
+    last_delta_ = state.last_delta;
+    rng_ = state.rng;
+    score_ = state.score;
+    ticks_ = state.ticks;
+    game_over_ = state.game_over;
+    undo_.clear();
+}
+
+bool SnakeGame::PlaceTarget(const Tile& tile) {
+    if (game_over_ || !IsFree(tile)) {
+        return false;
+    }
+    curr_target_ = {
+        .row = tile.row, .col = tile.col, .direction = Direction::kNone};
+    return true;
+}
+
+void SnakeGame::EnableUndo(bool enable) {
+    undo_enabled_ = enable;
+    if (!enable) {
+        undo_.clear();
+    }
+}
+
+void SnakeGame::Undo(std::size_t num_ticks) {
+    for (; num_ticks && !undo_.empty(); --num_ticks) {
+        const TickUndo& undo = undo_.back();
+
+        /* reverse the steps of Tick() in the opposite order */
+        if (kNotFree != undo.grow_pos) {
+            UnoccupyCell(CellIndex(snake_.back()), undo.grow_pos);
+            snake_.pop_back();
+        }
+        if (kNotFree != undo.head_pos) {
+            UnoccupyCell(CellIndex(snake_.front()), undo.head_pos);
+        }
+        snake_.pop_front();
+        UnvacateCell(CellIndex(undo.tail));
+        snake_.push_back(undo.tail);
 
-    /* ensure the target does not overlap the snake head */
-    while (targets_[curr_target_] == snake_.front()) {
-        curr_target_ = (curr_target_ + 1) % static_cast<int>(targets_.size());
+        curr_target_ = undo.target;
+        last_delta_ = undo.last_delta;
+        rng_ = undo.rng;
+        score_ = undo.score;
+        game_over_ = false; /* ticks aren't recorded once the game is over */
+        ticks_--;
+        undo_.pop_back();
     }
 }
 
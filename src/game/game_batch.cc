@@ -0,0 +1,257 @@
+#include "game/game_batch.hpp"
+
+namespace snake {
+namespace game {
+
+SnakeGameBatch::SnakeGameBatch(const ScreenDimension& dim,
+                               std::size_t num_games, int border)
+    : border_(border),
+      screen_dim_(dim),
+      num_cells_(static_cast<std::size_t>(dim.width * dim.height)),
+      capacity_(static_cast<std::size_t>((dim.width - 2 * border) *
+                                         (dim.height - 2 * border))),
+      head_row_(num_games),
+      head_col_(num_games),
+      head_dir_(num_games),
+      target_row_(num_games),
+      target_col_(num_games),
+      score_(num_games),
+      length_(num_games),
+      ring_head_(num_games),
+      free_count_(num_games),
+      game_over_(num_games),
+      rng_(num_games),
+      next_row_(num_games),
+      next_col_(num_games),
+      next_dir_(num_games),
+      in_bounds_(num_games),
+      hit_target_(num_games),
+      body_cells_(num_games * capacity_),
+      body_dirs_(GetPackedDirectionBytes(num_games * capacity_)),
+      occupied_(num_games * num_cells_),
+      free_cells_(num_games * capacity_),
+      free_index_(num_games * num_cells_) {
+    for (std::size_t i = 0; i < num_games; ++i) {
+        Reset(i, i);
+    }
+}
+
+std::size_t SnakeGameBatch::BodySlot(std::size_t game, std::size_t i) const {
+    std::size_t slot = ring_head_[game] + i;
+    return BodyBase(game) + ((slot >= capacity_) ? (slot - capacity_) : slot);
+}
+
+Tile SnakeGameBatch::GetSnakeTile(std::size_t game, std::size_t i) const {
+    /* the head is tracked separately since it may have left the board */
+    if (0 == i) {
+        return {.row = head_row_[game],
+                .col = head_col_[game],
+                .direction = head_dir_[game]};
+    }
+
+    const std::size_t kSlot = BodySlot(game, i);
+    return {.row = body_cells_[kSlot] / screen_dim_.width,
+            .col = body_cells_[kSlot] % screen_dim_.width,
+            .direction = GetPackedDirection(body_dirs_.data(), kSlot)};
+}
+
+bool SnakeGameBatch::IsFree(std::size_t game, const Tile& tile) const {
+    bool is_in_bounds = (tile.row >= border_) &&
+                        (tile.row < (screen_dim_.height - border_)) &&
+                        (tile.col >= border_) &&
+                        (tile.col < (screen_dim_.width - border_));
+    return (is_in_bounds &&
+            !occupied_[CellBase(game) + CellIndex(tile.row, tile.col)]);
+}
+
+void SnakeGameBatch::OccupyCell(std::size_t game, int cell) {
+    /* identical to SnakeGame::OccupyCell() so free cells stay in the same
+     * order as in the scalar game */
+    int* free_cells = &free_cells_[BodyBase(game)];
+    int* free_index = &free_index_[CellBase(game)];
+
+    int pos = free_index[cell];
+    int last = free_cells[free_count_[game] - 1];
+    free_cells[pos] = last;
+    free_index[last] = pos;
+    free_count_[game]--;
+    free_index[cell] = kNotFree;
+
+    occupied_[CellBase(game) + cell] = 1;
+}
+
+void SnakeGameBatch::VacateCell(std::size_t game, int cell) {
+    free_index_[CellBase(game) + cell] = static_cast<int>(free_count_[game]);
+    free_cells_[BodyBase(game) + free_count_[game]] = cell;
+    free_count_[game]++;
+
+    occupied_[CellBase(game) + cell] = 0;
+}
+
+void SnakeGameBatch::SpawnTarget(std::size_t game) {
+    int cell = free_cells_[BodyBase(game) +
+                           rng_[game].Below(
+                               static_cast<std::uint32_t>(free_count_[game]))];
+    target_row_[game] = cell / screen_dim_.width;
+    target_col_[game] = cell % screen_dim_.width;
+}
+
+void SnakeGameBatch::Reset(std::size_t game, std::uint64_t seed) {
+    rng_[game].Seed(seed);
+    game_over_[game] = 0;
+    score_[game] = 0;
+
+    /* every playable tile starts out free, listed in row major order */
+    int* free_index = &free_index_[CellBase(game)];
+    for (std::size_t i = 0; i < num_cells_; ++i) {
+        occupied_[CellBase(game) + i] = 0;
+        free_index[i] = kNotFree;
+    }
+    free_count_[game] = 0;
+    for (int i = border_; i < (screen_dim_.height - border_); ++i) {
+        for (int j = border_; j < (screen_dim_.width - border_); ++j) {
+            VacateCell(game, CellIndex(i, j));
+        }
+    }
+
+    /* spawn the snake head in the center of the screen with a random
+     * direction, drawing from the generator in the same order as SnakeGame */
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    Direction direction = kDirections[rng_[game].Below(4)];
+    head_row_[game] = screen_dim_.height / 2;
+    head_col_[game] = screen_dim_.width / 2;
+    head_dir_[game] = direction;
+    ring_head_[game] = 0;
+    length_[game] = 1;
+    body_cells_[BodyBase(game)] = CellIndex(head_row_[game], head_col_[game]);
+    SetPackedDirection(body_dirs_.data(), BodyBase(game), direction);
+    OccupyCell(game, body_cells_[BodyBase(game)]);
+
+    /* see SnakeGame::Reset() */
+    if (SnakeWins(game)) {
+        target_row_[game] = head_row_[game];
+        target_col_[game] = head_col_[game];
+        game_over_[game] = 1;
+        return;
+    }
+    SpawnTarget(game);
+}
+
+/**
+ * Compute the next head direction and position of num_games games and test
+ * the position against the border and the target.
+ *
+ * The loop is branch free and the pointers are declared not to alias so that
+ * the compiler vectorizes it.
+ */
+static void StepHeads(int num_games, const ScreenDimension& dim, int border,
+                      const Direction* __restrict directions,
+                      const int* __restrict head_row,
+                      const int* __restrict head_col,
+                      const Direction* __restrict head_dir,
+                      const int* __restrict target_row,
+                      const int* __restrict target_col,
+                      int* __restrict next_row, int* __restrict next_col,
+                      Direction* __restrict next_dir,
+                      std::uint8_t* __restrict in_bounds,
+                      std::uint8_t* __restrict hit_target) {
+    const int kMinRow = border;
+    const int kMaxRow = dim.height - border;
+    const int kMinCol = border;
+    const int kMaxCol = dim.width - border;
+    const int kNone = static_cast<int>(Direction::kNone);
+    const int kUp = static_cast<int>(Direction::kUp);
+    const int kDown = static_cast<int>(Direction::kDown);
+    const int kLeft = static_cast<int>(Direction::kLeft);
+    const int kRight = static_cast<int>(Direction::kRight);
+    for (int i = 0; i < num_games; ++i) {
+        /* Direction::kNone keeps the head direction, blended through a mask
+         * rather than selected with a branch which would stop the loop from
+         * being vectorized */
+        const int kRequested = static_cast<int>(directions[i]);
+        const int kKeep = -static_cast<int>(kRequested == kNone);
+        const int kDirection = (static_cast<int>(head_dir[i]) & kKeep) |
+                               (kRequested & ~kKeep);
+        const int kRow =
+            head_row[i] + (kDirection == kDown) - (kDirection == kUp);
+        const int kCol =
+            head_col[i] + (kDirection == kRight) - (kDirection == kLeft);
+        next_row[i] = kRow;
+        next_col[i] = kCol;
+        next_dir[i] = static_cast<Direction>(kDirection);
+        in_bounds[i] = (kRow >= kMinRow) & (kRow < kMaxRow) &
+                       (kCol >= kMinCol) & (kCol < kMaxCol);
+        hit_target[i] = (kRow == target_row[i]) & (kCol == target_col[i]);
+    }
+}
+
+void SnakeGameBatch::Tick(const Direction* directions) {
+    const int kNumGames = static_cast<int>(Size());
+
+    StepHeads(kNumGames, screen_dim_, border_, directions, head_row_.data(),
+              head_col_.data(), head_dir_.data(), target_row_.data(),
+              target_col_.data(), next_row_.data(), next_col_.data(),
+              next_dir_.data(), in_bounds_.data(), hit_target_.data());
+
+    /* the body, grid and free cell updates touch a different region of memory
+     * per game and are done one game at a time */
+    for (int i = 0; i < kNumGames; ++i) {
+        if (!game_over_[i]) {
+            FinishTick(static_cast<std::size_t>(i), next_dir_[i]);
+        }
+    }
+}
+
+void SnakeGameBatch::FinishTick(std::size_t game, Direction direction) {
+    /* the tail vacates its tile before the head moves, see
+     * SnakeGame::MoveSnake() */
+    VacateCell(game, body_cells_[BodySlot(game, length_[game] - 1)]);
+    ring_head_[game] =
+        (0 == ring_head_[game]) ? (capacity_ - 1) : (ring_head_[game] - 1);
+    head_row_[game] = next_row_[game];
+    head_col_[game] = next_col_[game];
+    head_dir_[game] = direction;
+    const std::size_t kHeadSlot = BodySlot(game, 0);
+    SetPackedDirection(body_dirs_.data(), kHeadSlot, direction);
+
+    if (!in_bounds_[game]) {
+        game_over_[game] = 1;
+        return;
+    }
+    const int kHeadCell = CellIndex(head_row_[game], head_col_[game]);
+    body_cells_[kHeadSlot] = kHeadCell;
+    if (occupied_[CellBase(game) + kHeadCell]) {
+        game_over_[game] = 1;
+        return;
+    }
+    OccupyCell(game, kHeadCell);
+
+    if (!hit_target_[game]) {
+        return;
+    }
+    score_[game] += kScoreIncrement;
+
+    /* extend the snake into the tile its tail just vacated, see
+     * SnakeGame::ExtendSnake() */
+    const std::size_t kTailSlot = BodySlot(game, length_[game] - 1);
+    Tile tail = {.row = body_cells_[kTailSlot] / screen_dim_.width,
+                 .col = body_cells_[kTailSlot] % screen_dim_.width,
+                 .direction = GetPackedDirection(body_dirs_.data(),
+                                                 kTailSlot)};
+    Tile new_tail = Neighbor(tail, Opposite(tail.direction));
+    const std::size_t kNewTailSlot = BodySlot(game, length_[game]);
+    body_cells_[kNewTailSlot] = CellIndex(new_tail.row, new_tail.col);
+    SetPackedDirection(body_dirs_.data(), kNewTailSlot, new_tail.direction);
+    length_[game]++;
+    OccupyCell(game, body_cells_[kNewTailSlot]);
+
+    if (SnakeWins(game)) {
+        game_over_[game] = 1;
+        return;
+    }
+    SpawnTarget(game);
+}
+
+}  // namespace game
+}  // namespace snake
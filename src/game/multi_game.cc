@@ -0,0 +1,220 @@
+#include "game/multi_game.hpp"
+
+#include <algorithm>
+
+namespace snake {
+namespace game {
+
+MultiSnakeGame::MultiSnakeGame(const ScreenDimension& dim,
+                               std::size_t num_snakes, std::size_t num_targets,
+                               int border, const Rng& rng)
+    : border_(border),
+      screen_dim_(dim),
+      num_targets_(num_targets),
+      rng_(rng),
+      snakes_(num_snakes),
+      alive_(num_snakes, 0),
+      score_(num_snakes, 0),
+      next_head_(num_snakes),
+      eats_(num_snakes, 0),
+      dies_(num_snakes, 0) {
+    const auto kNumCells = static_cast<std::size_t>(dim.width * dim.height);
+    owner_.resize(kNumCells);
+    target_index_.resize(kNumCells);
+    free_index_.resize(kNumCells);
+    claims_.assign(kNumCells, 0);
+    free_cells_.reserve(kNumCells);
+    targets_.reserve(num_targets);
+    for (Snake& snake : snakes_) {
+        snake.Reset(kInitialCapacity);
+    }
+
+    Reset();
+}
+
+void MultiSnakeGame::TakeCell(int cell) {
+    /* swap the cell with the last free cell and drop it from the free set */
+    const int kPos = free_index_[cell];
+    const int kLast = free_cells_.back();
+    free_cells_[kPos] = kLast;
+    free_index_[kLast] = kPos;
+    free_cells_.pop_back();
+    free_index_[cell] = kNotFree;
+}
+
+void MultiSnakeGame::FreeCell(int cell) {
+    free_index_[cell] = static_cast<int>(free_cells_.size());
+    free_cells_.push_back(cell);
+}
+
+int MultiSnakeGame::TakeRandomCell() {
+    const int kCell = free_cells_[rng_.Below(
+        static_cast<std::uint32_t>(free_cells_.size()))];
+    TakeCell(kCell);
+    return kCell;
+}
+
+void MultiSnakeGame::PushHead(std::size_t snake, const Tile& head) {
+    Snake& body = snakes_[snake];
+    if (body.full()) {
+        body.Grow(std::max(kInitialCapacity, 2 * body.capacity()));
+    }
+    body.push_front(head);
+    owner_[CellIndex(head)] = static_cast<int>(snake);
+}
+
+void MultiSnakeGame::RemoveSnake(std::size_t snake) {
+    for (const Tile& tile : snakes_[snake]) {
+        const int kCell = CellIndex(tile);
+        owner_[kCell] = kNoSnake;
+        FreeCell(kCell);
+    }
+    snakes_[snake].clear();
+    alive_[snake] = 0;
+    num_alive_--;
+}
+
+void MultiSnakeGame::SpawnTarget() {
+    const int kCell = TakeRandomCell();
+    target_index_[kCell] = static_cast<int>(targets_.size());
+    targets_.push_back({.row = kCell / screen_dim_.width,
+                        .col = kCell % screen_dim_.width,
+                        .direction = Direction::kNone});
+}
+
+void MultiSnakeGame::RemoveTarget(int cell) {
+    /* move the last target into the removed target's position */
+    const int kPos = target_index_[cell];
+    const Tile kLast = targets_.back();
+    targets_[kPos] = kLast;
+    target_index_[CellIndex(kLast)] = kPos;
+    targets_.pop_back();
+    target_index_[cell] = kNoTarget;
+}
+
+void MultiSnakeGame::Tick(const Direction* directions) {
+    if (GameOver()) {
+        return;
+    }
+    ticks_++;
+    claim_stamp_++;
+
+    /* compute every new head, note which land on a target and count the
+     * heads moving onto each Tile */
+    const std::size_t kNumSnakes = snakes_.size();
+    const std::uint64_t kClaimed = claim_stamp_ << 1;
+    for (std::size_t i = 0; i < kNumSnakes; ++i) {
+        if (!alive_[i]) {
+            continue;
+        }
+        const Tile kHead = snakes_[i].front();
+        const Direction kDirection = (Direction::kNone == directions[i])
+                                         ? kHead.direction
+                                         : directions[i];
+        Tile head = Neighbor(kHead, kDirection);
+        head.direction = kDirection;
+        next_head_[i] = head;
+        eats_[i] = 0;
+        if (IsInBounds(head)) {
+            const int kCell = CellIndex(head);
+            eats_[i] = (kNoTarget != target_index_[kCell]);
+            claims_[kCell] = ((claims_[kCell] >> 1) == claim_stamp_)
+                                 ? (kClaimed | 1)
+                                 : kClaimed;
+        }
+    }
+
+    /* (1) the tails of the snakes that don't grow move on */
+    for (std::size_t i = 0; i < kNumSnakes; ++i) {
+        if (alive_[i] && !eats_[i]) {
+            const int kCell = CellIndex(snakes_[i].back());
+            owner_[kCell] = kNoSnake;
+            FreeCell(kCell);
+            snakes_[i].pop_back();
+        }
+    }
+
+    /* (2) decide every death before changing the board any further so the
+     * outcome does not depend on the order of the snakes */
+    for (std::size_t i = 0; i < kNumSnakes; ++i) {
+        if (!alive_[i]) {
+            continue;
+        }
+        const Tile& head = next_head_[i];
+        dies_[i] = !IsInBounds(head) ||
+                   (kNoSnake != owner_[CellIndex(head)]) ||
+                   ((kClaimed | 1) == claims_[CellIndex(head)]);
+    }
+
+    /* (3) move the survivors, a head either eats a target or takes a free
+     * Tile */
+    for (std::size_t i = 0; i < kNumSnakes; ++i) {
+        if (!alive_[i] || dies_[i]) {
+            continue;
+        }
+        const int kCell = CellIndex(next_head_[i]);
+        if (eats_[i]) {
+            RemoveTarget(kCell);
+            score_[i] += kScoreIncrement;
+        } else {
+            TakeCell(kCell);
+        }
+        PushHead(i, next_head_[i]);
+    }
+
+    /* (4) clear the dead and replace the eaten targets */
+    for (std::size_t i = 0; i < kNumSnakes; ++i) {
+        if (alive_[i] && dies_[i]) {
+            RemoveSnake(i);
+        }
+    }
+    while ((targets_.size() < num_targets_) && !free_cells_.empty()) {
+        SpawnTarget();
+    }
+}
+
+void MultiSnakeGame::Reset() {
+    ticks_ = 0;
+
+    /* every playable tile starts out free, listed in row major order */
+    std::fill(owner_.begin(), owner_.end(), kNoSnake);
+    std::fill(target_index_.begin(), target_index_.end(), kNoTarget);
+    std::fill(free_index_.begin(), free_index_.end(), kNotFree);
+    free_cells_.clear();
+    for (int i = border_; i < (screen_dim_.height - border_); ++i) {
+        for (int j = border_; j < (screen_dim_.width - border_); ++j) {
+            FreeCell(CellIndex({.row = i, .col = j}));
+        }
+    }
+    targets_.clear();
+
+    const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                     Direction::kLeft, Direction::kRight};
+    num_alive_ = 0;
+    for (std::size_t i = 0; i < snakes_.size(); ++i) {
+        snakes_[i].clear();
+        score_[i] = 0;
+        alive_[i] = !free_cells_.empty();
+        if (!alive_[i]) {
+            continue;
+        }
+
+        const int kCell = TakeRandomCell();
+        PushHead(i, {.row = kCell / screen_dim_.width,
+                     .col = kCell % screen_dim_.width,
+                     .direction = kDirections[rng_.Below(4)]});
+        num_alive_++;
+    }
+
+    while ((targets_.size() < num_targets_) && !free_cells_.empty()) {
+        SpawnTarget();
+    }
+}
+
+void MultiSnakeGame::Reset(std::uint64_t seed) {
+    rng_.Seed(seed);
+    Reset();
+}
+
+}  // namespace game
+}  // namespace snake
@@ -0,0 +1,317 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "banners.hpp"
+#include "graphics/renderer.hpp"
+
+namespace snake {
+namespace graphics {
+
+/* escape sequences, see ECMA-48 and the DEC special graphics character set */
+static const char kClearScreen[] = "\x1b[H\x1b[2J";
+static const char kPlainStyle[] = "\x1b[0m";
+static const char kRedStyle[] = "\x1b[0;1;31;40m";
+static const char kGreenStyle[] = "\x1b[0;1;32;40m";
+static const char kCyanStyle[] = "\x1b[0;1;36;40m";
+static const char kLineDrawingOn[] = "\x1b(0";
+static const char kLineDrawingOff[] = "\x1b(B";
+
+/* the same glyphs ncurses uses for ACS_DIAMOND and box() */
+static const char kDiamond[] = "\x1b(0`\x1b(B";
+static const char kTopLeft = 'l';
+static const char kTopRight = 'k';
+static const char kBottomLeft = 'm';
+static const char kBottomRight = 'j';
+static const char kHorizontal = 'q';
+static const char kVertical = 'x';
+
+/* the length of a string literal without its terminator */
+template <std::size_t N>
+static constexpr std::size_t Len(const char (&)[N]) {
+    return N - 1;
+}
+
+AnsiRenderer::AnsiRenderer(int fd, std::size_t buffer_size)
+    : fd_(fd), buffer_(std::max<std::size_t>(buffer_size, 1)) {}
+
+void AnsiRenderer::Reserve(std::size_t num_bytes) {
+    if ((len_ + num_bytes) > buffer_.size()) {
+        buffer_.resize(std::max(2 * buffer_.size(), len_ + num_bytes));
+    }
+}
+
+void AnsiRenderer::Append(const char* bytes, std::size_t num_bytes) {
+    Reserve(num_bytes);
+    std::memcpy(buffer_.data() + len_, bytes, num_bytes);
+    len_ += num_bytes;
+}
+
+void AnsiRenderer::AppendInt(int value) {
+    /* enough digits for any int, written back to front */
+    char digits[16];
+    char* pos = digits + sizeof(digits);
+    const bool kNegative = (value < 0);
+    unsigned magnitude = kNegative ? (0u - static_cast<unsigned>(value))
+                                   : static_cast<unsigned>(value);
+    do {
+        *--pos = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (kNegative) {
+        *--pos = '-';
+    }
+    Append(pos, static_cast<std::size_t>(digits + sizeof(digits) - pos));
+}
+
+void AnsiRenderer::MoveTo(int row, int col) {
+    if ((row == cursor_row_) && (col == cursor_col_)) {
+        return;
+    }
+    Append("\x1b[", 2);
+    AppendInt(row + 1);
+    Append(";", 1);
+    AppendInt(col + 1);
+    Append("H", 1);
+    cursor_row_ = row;
+    cursor_col_ = col;
+}
+
+void AnsiRenderer::SetStyle(Style style) {
+    if (style == style_) {
+        return;
+    }
+    switch (style) {
+        case Style::kUnknown:
+        case Style::kPlain:
+            Append(kPlainStyle, Len(kPlainStyle));
+            break;
+        case Style::kRed:
+            Append(kRedStyle, Len(kRedStyle));
+            break;
+        case Style::kGreen:
+            Append(kGreenStyle, Len(kGreenStyle));
+            break;
+        case Style::kCyan:
+            Append(kCyanStyle, Len(kCyanStyle));
+            break;
+    }
+    style_ = style;
+}
+
+/**
+ * Return true if the Tile lies on the screen, the head of a lost game may
+ * not.
+ */
+static bool IsOnScreen(const snake::game::Tile& tile,
+                       const snake::game::ScreenDimension& dim) {
+    return (tile.row >= 0) && (tile.row < dim.height) && (tile.col >= 0) &&
+           (tile.col < dim.width);
+}
+
+void AnsiRenderer::DrawChar(const snake::game::Tile& tile, Style style,
+                            char c) {
+    MoveTo(tile.row, tile.col);
+    SetStyle(style);
+    Append(&c, 1);
+
+    /* the cursor stays put after writing the last column */
+    cursor_col_ = ((tile.col + 1) < width_) ? (tile.col + 1) : -1;
+}
+
+void AnsiRenderer::DrawTarget(const snake::game::Tile& target) {
+    MoveTo(target.row, target.col);
+    SetStyle(Style::kRed);
+    Append(kDiamond, Len(kDiamond));
+    cursor_col_ = ((target.col + 1) < width_) ? (target.col + 1) : -1;
+}
+
+void AnsiRenderer::DrawSnakeHead(const snake::game::Tile& head) {
+    char c = '?';
+    switch (head.direction) {
+        case snake::game::Direction::kUp:
+            c = '^';
+            break;
+        case snake::game::Direction::kDown:
+            c = 'v';
+            break;
+        case snake::game::Direction::kLeft:
+            c = '<';
+            break;
+        case snake::game::Direction::kRight:
+            c = '>';
+            break;
+        case snake::game::Direction::kNone:
+            break;
+    }
+    DrawChar(head, Style::kGreen, c);
+}
+
+void AnsiRenderer::DrawBorder(const snake::game::ScreenDimension& dim) {
+    /* like box(), the border follows the edge of the screen */
+    const auto kInnerWidth = static_cast<std::size_t>(dim.width - 2);
+    SetStyle(Style::kPlain);
+    for (int row = 0; row < dim.height; ++row) {
+        const bool kIsTop = (0 == row);
+        const bool kIsBottom = ((dim.height - 1) == row);
+        MoveTo(row, 0);
+        Append(kLineDrawingOn, Len(kLineDrawingOn));
+        if (kIsTop || kIsBottom) {
+            Append(kIsTop ? &kTopLeft : &kBottomLeft, 1);
+            Reserve(kInnerWidth);
+            std::memset(buffer_.data() + len_, kHorizontal, kInnerWidth);
+            len_ += kInnerWidth;
+            Append(kIsTop ? &kTopRight : &kBottomRight, 1);
+        } else {
+            Append(&kVertical, 1);
+            MoveTo(row, dim.width - 1);
+            Append(&kVertical, 1);
+        }
+        Append(kLineDrawingOff, Len(kLineDrawingOff));
+        cursor_col_ = -1;
+    }
+}
+
+void AnsiRenderer::ClearScreen(const snake::game::ScreenDimension& dim) {
+    width_ = dim.width;
+    style_ = Style::kUnknown;
+    SetStyle(Style::kPlain);
+    Append(kClearScreen, Len(kClearScreen));
+    cursor_row_ = 0;
+    cursor_col_ = 0;
+}
+
+void AnsiRenderer::Flush() {
+    std::size_t written = 0;
+    while (written < len_) {
+        const ssize_t kWritten =
+            write(fd_, buffer_.data() + written, len_ - written);
+        if (kWritten < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            /* the terminal went away, drop the frame and assume nothing
+             * about what the screen shows */
+            cursor_row_ = -1;
+            style_ = Style::kUnknown;
+            drawn_tick_ = kNoFrame;
+            break;
+        }
+        written += static_cast<std::size_t>(kWritten);
+    }
+    bytes_written_ += written;
+    len_ = 0;
+}
+
+void AnsiRenderer::DrawSnakeScreen(const snake::game::SnakeGame& game) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    const snake::game::Snake& snake = game.GetSnake();
+
+    /* a delta only describes the step from the previous tick, if the screen
+     * shows anything else, including the same game before a resize, the whole
+     * board is redrawn */
+    const bool kIsNextTick = (&game == drawn_game_) &&
+                             (drawn_tick_ != kNoFrame) &&
+                             (game.GetTicks() == drawn_tick_ + 1) &&
+                             (kDim.width == drawn_dim_.width) &&
+                             (kDim.height == drawn_dim_.height);
+    if (kIsNextTick) {
+        /* the order matters: the head may move onto the tile the tail
+         * vacated */
+        const snake::game::TickDelta& delta = game.GetLastDelta();
+        if (snake.size() > 1) {
+            DrawChar(delta.prev_head, Style::kGreen, 'O');
+        }
+        if (delta.tail_vacated) {
+            DrawChar(delta.vacated_tail, Style::kPlain, ' ');
+        }
+        if (delta.target_moved) {
+            DrawTarget(game.GetTargetTile());
+        }
+        if (IsOnScreen(delta.head, kDim)) {
+            DrawSnakeHead(delta.head);
+        }
+    } else {
+        ClearScreen(kDim);
+        if (game.GetBorder()) {
+            DrawBorder(kDim);
+        }
+        DrawTarget(game.GetTargetTile());
+        if (IsOnScreen(snake.front(), kDim)) {
+            DrawSnakeHead(snake.front());
+        }
+        for (std::size_t i = 1; i < snake.size(); ++i) {
+            DrawChar(snake[i], Style::kGreen, 'O');
+        }
+    }
+    drawn_game_ = &game;
+    drawn_dim_ = kDim;
+    drawn_tick_ = game.GetTicks();
+
+    Flush();
+}
+
+void AnsiRenderer::DrawGameOverScreen(const snake::game::SnakeGame& game,
+                                      int high_score) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    ClearScreen(kDim);
+    drawn_tick_ = kNoFrame;
+
+    /* text lines may run past the screen's edge, where the cursor ends up is
+     * left unknown after each */
+    auto draw_line = [this](int row, int col, Style style,
+                            const std::string& text) {
+        MoveTo(row, std::max(col, 0));
+        SetStyle(style);
+        Append(text.data(), text.size());
+        cursor_row_ = -1;
+    };
+
+    /* display the game over banner */
+    for (std::size_t i = 0; i < kGameOverBanner.size(); ++i) {
+        draw_line(static_cast<int>(i),
+                  (kDim.width - static_cast<int>(kGameOverBanner[i].size())) /
+                      2,
+                  (i & 1) ? Style::kRed : Style::kGreen, kGameOverBanner[i]);
+    }
+
+    /* display the player's score */
+    draw_line(static_cast<int>(kGameOverBanner.size()) + 2,
+              (kDim.width - static_cast<int>(kScoreBanner.size())) / 2,
+              Style::kCyan, kScoreBanner + ": ");
+    AppendInt(game.GetScore());
+    if (kNoHighScore != high_score) {
+        draw_line(static_cast<int>(kGameOverBanner.size()) + 3,
+                  (kDim.width - static_cast<int>(kHighScoreBanner.size())) / 2,
+                  Style::kCyan, kHighScoreBanner + ": ");
+        AppendInt(high_score);
+    }
+
+    /* display the quit banner */
+    draw_line(kDim.height - 1, 0, Style::kPlain, kQuitBanner);
+
+    Flush();
+}
+
+void AnsiRenderer::DrawMessageScreen(const snake::game::ScreenDimension& dim,
+                                     const std::string& message) {
+    ClearScreen(dim);
+    drawn_tick_ = kNoFrame;
+
+    /* cut the message off at the screen's edge like ncurses does rather
+     * than let it wrap */
+    const auto kWidth = static_cast<std::size_t>(std::max(dim.width, 0));
+    const std::size_t kLen = std::min(message.size(), kWidth);
+    MoveTo(dim.height / 2, (dim.width - static_cast<int>(kLen)) / 2);
+    SetStyle(Style::kCyan);
+    Append(message.data(), kLen);
+    cursor_row_ = -1;
+
+    Flush();
+}
+
+}  // namespace graphics
+}  // namespace snake
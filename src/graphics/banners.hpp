@@ -0,0 +1,32 @@
+#ifndef BANNERS_HPP_
+#define BANNERS_HPP_
+
+#include <string>
+#include <vector>
+
+namespace snake {
+namespace graphics {
+
+/* text drawn by every renderer's game over screen */
+inline const std::vector<std::string> kGameOverBanner = {
+    " _____   ___  ___  ___ _____ ",
+    "|  __ \\ / _ \\ |  \\/  ||  ___|",
+    "| |  \\// /_\\ \\| .  . || |__  ",
+    "| | __ |  _  || |\\/| ||  __| ",
+    "| |_\\ \\| | | || |  | || |___ ",
+    " \\____/\\_| |_/\\_|  |_/\\____/ ",
+    " _____  _   _  _____ ______  ",
+    "|  _  || | | ||  ___|| ___ \\ ",
+    "| | | || | | || |__  | |_/ / ",
+    "| | | || | | ||  __| |    /  ",
+    "\\ \\_/ /\\ \\_/ /| |___ | |\\ \\  ",
+    " \\___/  \\___/ \\____/ \\_| \\_| ",
+};
+inline const std::string kScoreBanner("SCORE");
+inline const std::string kHighScoreBanner("HIGH SCORE");
+inline const std::string kQuitBanner("press q to quit");
+
+}  // namespace graphics
+}  // namespace snake
+
+#endif
@@ -0,0 +1,141 @@
+#include "graphics/render_thread.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <utility>
+
+#include "graphics/screen.hpp"
+#include "metrics/metrics.hpp"
+
+namespace snake {
+namespace graphics {
+
+/** Return a frame of the parameter game. */
+static Frame MakeFrame(const snake::game::SnakeGame& game) {
+    Frame frame;
+    game.SaveState(frame.state);
+    frame.dim = game.GetScreenDimension();
+    return frame;
+}
+
+RenderThread::RenderThread(const snake::game::SnakeGame& game,
+                           snake::game::InputQueue& input, DrawFunction draw)
+    : input_(input),
+      draw_(std::move(draw)),
+      frames_(MakeFrame(game)),
+      view_(game),
+      wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    thread_ = std::thread(&RenderThread::Run, this);
+
+    /* the render thread was started with SIGWINCH unblocked, block it here so
+     * that it interrupts the render thread's wait instead */
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &mask, &prev_mask_);
+}
+
+RenderThread::~RenderThread() { Stop(); }
+
+void RenderThread::Publish(const snake::game::SnakeGame& game, bool paused) {
+    Frame& frame = frames_.Back();
+    game.SaveState(frame.state);
+    frame.dim = game.GetScreenDimension();
+    frame.paused = paused;
+    frames_.Publish();
+    Wake();
+}
+
+bool RenderThread::TakeResize(snake::game::ScreenDimension& dim) {
+    const std::uint64_t kResize =
+        resize_.exchange(0, std::memory_order_acq_rel);
+    if (!kResize) {
+        return false;
+    }
+    dim = {.width = static_cast<int>(kResize >> 32),
+           .height = static_cast<int>(kResize & 0xffffffff)};
+    return true;
+}
+
+void RenderThread::Stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stop_.store(true, std::memory_order_release);
+    Wake();
+    thread_.join();
+
+    pthread_sigmask(SIG_SETMASK, &prev_mask_, nullptr);
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+void RenderThread::Wake() {
+    const std::uint64_t kOne = 1;
+    ssize_t written = write(wake_fd_, &kOne, sizeof(kOne));
+    (void)written; /* fails only if the counter is full, i.e., already set */
+}
+
+void RenderThread::RestoreView(const Frame& frame) {
+    /* a state only restores onto a board of the same size, the view is
+     * rebuilt for a resized one which allocates but is rare */
+    const snake::game::ScreenDimension kDim = view_.GetScreenDimension();
+    if ((kDim.width != frame.dim.width) || (kDim.height != frame.dim.height)) {
+        view_ = snake::game::SnakeGame(frame.dim, view_.GetBorder(),
+                                       snake::game::Rng(0));
+    }
+    view_.RestoreState(frame.state);
+}
+
+void RenderThread::Run() {
+    /* without a wake up descriptor fall back to checking for frames every
+     * few milliseconds */
+    const int kFallbackTimeoutMs = 5;
+    pollfd fds[] = {{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0},
+                    {.fd = wake_fd_, .events = POLLIN, .revents = 0}};
+    for (;;) {
+        /* read before drawing: a frame published before Stop() was called
+         * is still drawn */
+        const bool kStopping = stop_.load(std::memory_order_acquire);
+
+        {
+            SNAKE_METRICS_TIME(Metric::kInputLatency);
+            snake::game::Direction key = snake::game::Direction::kNone;
+            while (PollKeypad(0, key)) {
+                input_.Push(key);
+            }
+        }
+        snake::game::ScreenDimension dim = {.width = 0, .height = 0};
+        if (graphics::TakeResize(dim)) {
+            resize_.store((static_cast<std::uint64_t>(dim.width) << 32) |
+                              static_cast<std::uint32_t>(dim.height),
+                          std::memory_order_release);
+        }
+
+        /* frames published while the previous one was being drawn are
+         * dropped in favor of the latest */
+        if (frames_.Acquire()) {
+            RestoreView(frames_.Front());
+            draw_(view_, frames_.Front().paused);
+        }
+        if (kStopping) {
+            return;
+        }
+
+        /* sleep until a key press, a frame, Stop() or a resize signal */
+        const int kTimeoutMs = (wake_fd_ < 0) ? kFallbackTimeoutMs : -1;
+        if ((poll(fds, 2, kTimeoutMs) > 0) && (fds[1].revents & POLLIN)) {
+            std::uint64_t count = 0;
+            ssize_t num_read = read(wake_fd_, &count, sizeof(count));
+            (void)num_read; /* only resets the counter */
+        }
+    }
+}
+
+}  // namespace graphics
+}  // namespace snake
@@ -3,9 +3,15 @@
 #include <menu.h>
 #include <ncurses.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <string>
 #include <vector>
 
+#include "banners.hpp"
+#include "graphics/renderer.hpp"
+
 namespace snake {
 namespace graphics {
 
@@ -17,11 +23,8 @@ static void DrawTarget(const snake::game::SnakeGame& game) {
     attroff(COLOR_PAIR(Color::kRed) | A_BOLD);
 }
 
-static void DrawSnake(const snake::game::SnakeGame& game) {
-    snake::game::Snake snake = game.GetSnake();
-
+static void DrawSnakeHead(const snake::game::Tile& head) {
     attron(COLOR_PAIR(Color::kGreen) | A_BOLD);
-    const auto& head = snake.front();
     switch (head.direction) {
         case snake::game::Direction::kUp:
             mvaddch(head.row, head.col, '^');
@@ -39,13 +42,53 @@ static void DrawSnake(const snake::game::SnakeGame& game) {
             mvaddch(head.row, head.col, '?');
             break;
     }
+    attroff(COLOR_PAIR(Color::kGreen) | A_BOLD);
+}
+
+static void DrawSnakeBody(const snake::game::Tile& tile) {
+    attron(COLOR_PAIR(Color::kGreen) | A_BOLD);
+    mvaddch(tile.row, tile.col, 'O');
+    attroff(COLOR_PAIR(Color::kGreen) | A_BOLD);
+}
 
+static void DrawSnake(const snake::game::SnakeGame& game) {
+    const snake::game::Snake& snake = game.GetSnake();
+
+    DrawSnakeHead(snake.front());
     for (std::size_t i = 1; i < snake.size(); ++i) {
-        mvaddch(snake[i].row, snake[i].col, 'O');
+        DrawSnakeBody(snake[i]);
     }
-    attroff(COLOR_PAIR(Color::kGreen) | A_BOLD);
 }
 
+/**
+ * Redraw only the Tiles changed by the game's last tick.
+ *
+ * This keeps the amount of terminal output per frame constant regardless of
+ * the snake's length.
+ */
+static void DrawSnakeDelta(const snake::game::SnakeGame& game) {
+    const snake::game::TickDelta& delta = game.GetLastDelta();
+
+    /* the order matters: the head may move onto the tile the tail vacated */
+    if (game.GetSnake().size() > 1) {
+        DrawSnakeBody(delta.prev_head);
+    }
+    if (delta.tail_vacated) {
+        mvaddch(delta.vacated_tail.row, delta.vacated_tail.col, ' ');
+    }
+    if (delta.target_moved) {
+        DrawTarget(game);
+    }
+    DrawSnakeHead(delta.head);
+}
+
+/* the renderer used by DrawSnakeScreen() and DrawGameOverScreen() */
+static CursesRenderer curses_renderer;
+static Renderer* renderer = &curses_renderer;
+
+/* set when the terminal was resized and cleared by TakeResize() */
+static bool resize_pending = false;
+
 snake::game::ScreenDimension InitScreen() {
     initscr();
     cbreak();             /* disable line buffering */
@@ -68,12 +111,24 @@ snake::game::ScreenDimension InitScreen() {
 
 void TerminateScreen() { endwin(); }
 
+std::uint64_t GetBytesWritten() {
+    /* the kernel counts every byte the process passes to write() */
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    std::uint64_t value = 0;
+    while (io >> key >> value) {
+        if ("wchar:" == key) {
+            return value;
+        }
+    }
+    return 0;
+}
+
 void EnableInputDelay(int delay_ms) { timeout(delay_ms); }
 
 void DisableInputDelay() { timeout(-1); }
 
-snake::game::Direction ReadKeypad() {
-    int key = getch();
+static snake::game::Direction KeyToDirection(int key) {
     switch (key) {
         case KEY_UP:
             return snake::game::Direction::kUp;
@@ -92,8 +147,59 @@ snake::game::Direction ReadKeypad() {
     }
 }
 
+/**
+ * Note a resize of the terminal, ncurses having already resized stdscr.
+ *
+ * ncurses repaints the whole screen on the next refresh after a resize. That
+ * refresh is done right away, and with stdscr cleared since a renderer
+ * drawing around ncurses leaves stale contents in it, so that it cannot wipe
+ * out what the renderer draws next. The renderer then redraws in full.
+ */
+static void OnResize() {
+    resize_pending = true;
+    clear();
+    refresh();
+    renderer->Invalidate();
+}
+
+snake::game::Direction ReadKeypad() {
+    int key = getch();
+    if (KEY_RESIZE == key) {
+        OnResize();
+    }
+    return KeyToDirection(key);
+}
+
+bool PollKeypad(int timeout_ms, snake::game::Direction& direction) {
+    timeout(timeout_ms);
+    int key = getch();
+    if (ERR == key) {
+        return false;
+    }
+    if (KEY_RESIZE == key) {
+        OnResize();
+    }
+    direction = KeyToDirection(key);
+    return true;
+}
+
+bool TakeResize(snake::game::ScreenDimension& dim) {
+    if (!resize_pending) {
+        return false;
+    }
+    resize_pending = false;
+    getmaxyx(stdscr, dim.height, dim.width);
+    return true;
+}
+
+void SetRenderer(Renderer* new_renderer) {
+    renderer = new_renderer ? new_renderer : &curses_renderer;
+    renderer->Invalidate();
+}
+
 GameMode PromptForGameMode() {
     clear();
+    renderer->Invalidate();
 
     const std::vector<std::string> kTitleBanner = {
         " _____  _   _   ___   _   __ _____ ",
@@ -194,6 +300,10 @@ GameMode PromptForGameMode() {
             case KEY_UP:
                 menu_driver(start_menu, REQ_UP_ITEM);
                 break;
+            case KEY_RESIZE:
+                /* the game picks up the new dimensions once it starts */
+                resize_pending = true;
+                break;
         }
         wrefresh(start_menu_win);
     }
@@ -218,38 +328,55 @@ GameMode PromptForGameMode() {
     return ret;
 }
 
-void DrawSnakeScreen(const snake::game::SnakeGame& game) {
-    clear();
+void CursesRenderer::DrawSnakeScreen(const snake::game::SnakeGame& game) {
+    /* a delta only describes the step from the previous tick, if the screen
+     * shows anything else, including the same game before a resize, the whole
+     * board is redrawn */
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    bool is_next_tick = (&game == drawn_game_) && (drawn_tick_ != kNoFrame) &&
+                        (game.GetTicks() == drawn_tick_ + 1) &&
+                        (kDim.width == drawn_dim_.width) &&
+                        (kDim.height == drawn_dim_.height);
+    if (is_next_tick) {
+        DrawSnakeDelta(game);
+    } else {
+        clear();
 
-    if (game.GetBorder()) {
-        box(stdscr, 0, 0);
+        if (game.GetBorder()) {
+            box(stdscr, 0, 0);
+        }
+        DrawTarget(game);
+        DrawSnake(game);
     }
-    DrawTarget(game);
-    DrawSnake(game);
+    drawn_game_ = &game;
+    drawn_dim_ = kDim;
+    drawn_tick_ = game.GetTicks();
+
+    refresh();
+}
+
+void CursesRenderer::DrawMessageScreen(
+    const snake::game::ScreenDimension& dim, const std::string& message) {
+    clear();
+    drawn_tick_ = kNoFrame;
+
+    attron(COLOR_PAIR(Color::kCyan) | A_BOLD);
+    mvprintw(dim.height / 2,
+             std::max((dim.width - static_cast<int>(message.size())) / 2, 0),
+             "%s", message.c_str());
+    attroff(COLOR_PAIR(Color::kCyan) | A_BOLD);
 
     refresh();
 }
 
-void DrawGameOverScreen(const snake::game::SnakeGame& game) {
+void CursesRenderer::DrawGameOverScreen(const snake::game::SnakeGame& game,
+                                        int high_score) {
     clear();
+    drawn_tick_ = kNoFrame;
 
     snake::game::ScreenDimension dim = game.GetScreenDimension();
 
     /* display the game over banner */
-    const std::vector<std::string> kGameOverBanner = {
-        " _____   ___  ___  ___ _____ ",
-        "|  __ \\ / _ \\ |  \\/  ||  ___|",
-        "| |  \\// /_\\ \\| .  . || |__  ",
-        "| | __ |  _  || |\\/| ||  __| ",
-        "| |_\\ \\| | | || |  | || |___ ",
-        " \\____/\\_| |_/\\_|  |_/\\____/ ",
-        " _____  _   _  _____ ______  ",
-        "|  _  || | | ||  ___|| ___ \\ ",
-        "| | | || | | || |__  | |_/ / ",
-        "| | | || | | ||  __| |    /  ",
-        "\\ \\_/ /\\ \\_/ /| |___ | |\\ \\  ",
-        " \\___/  \\___/ \\____/ \\_| \\_| ",
-    };
     attron(A_BOLD);
     for (std::size_t i = 0; i < kGameOverBanner.size(); ++i) {
         if (i & 1) {
@@ -272,16 +399,35 @@ void DrawGameOverScreen(const snake::game::SnakeGame& game) {
 
     /* display the player's score */
     attron(COLOR_PAIR(Color::kCyan) | A_BOLD);
-    const std::string kScoreBanner("SCORE");
     mvprintw(static_cast<int>(kGameOverBanner.size()) + 2,
              (dim.width - static_cast<int>(kScoreBanner.size())) / 2,
              "%s: %d\n", kScoreBanner.c_str(), game.GetScore());
+    if (kNoHighScore != high_score) {
+        mvprintw(static_cast<int>(kGameOverBanner.size()) + 3,
+                 (dim.width - static_cast<int>(kHighScoreBanner.size())) / 2,
+                 "%s: %d\n", kHighScoreBanner.c_str(), high_score);
+    }
     attroff(COLOR_PAIR(Color::kCyan) | A_BOLD);
 
     /* display the quit banner */
-    const std::string kQuitBanner("press q to quit");
     mvprintw(dim.height - 1, 0, "%s", kQuitBanner.c_str());
 
+    refresh();
+}
+
+void DrawSnakeScreen(const snake::game::SnakeGame& game) {
+    renderer->DrawSnakeScreen(game);
+}
+
+void DrawMessageScreen(const std::string& message) {
+    snake::game::ScreenDimension dim = {.width = 0, .height = 0};
+    getmaxyx(stdscr, dim.height, dim.width);
+    renderer->DrawMessageScreen(dim, message);
+}
+
+void DrawGameOverScreen(const snake::game::SnakeGame& game, int high_score) {
+    renderer->DrawGameOverScreen(game, high_score);
+
     /* wait for the user to enter 'q' before quitting */
     int c = 0;
     while ((c = getch()) != 'q') {
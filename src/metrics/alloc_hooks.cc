@@ -0,0 +1,54 @@
+#include "metrics/alloc_hooks.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/* the replacements live in a translation unit of their own so that no
+ * caller sees a malloc() inlined next to its matching free() */
+
+/* calls made to the global operator new, see GetNumAllocations() */
+static std::atomic<std::uint64_t> num_allocations(0);
+
+void* operator new(std::size_t size) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+/* memory resources allocate through the aligned forms */
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto kAlignment = static_cast<std::size_t>(alignment);
+    const std::size_t kSize =
+        size ? ((size + kAlignment - 1) / kAlignment * kAlignment) : kAlignment;
+    void* ptr = std::aligned_alloc(kAlignment, kSize);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+namespace snake {
+namespace metrics {
+
+std::uint64_t GetNumAllocations() {
+    return num_allocations.load(std::memory_order_relaxed);
+}
+
+}  // namespace metrics
+}  // namespace snake
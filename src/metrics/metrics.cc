@@ -0,0 +1,257 @@
+#include "metrics/metrics.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "metrics/alloc_hooks.hpp"
+
+namespace snake {
+namespace metrics {
+
+const char* MetricName(Metric metric) {
+    switch (metric) {
+        case Metric::kTickLatency:
+            return "tick_latency";
+        case Metric::kRenderLatency:
+            return "render_latency";
+        case Metric::kInputLatency:
+            return "input_latency";
+        case Metric::kSnakeLength:
+            return "snake_length";
+        case Metric::kAllocations:
+            return "allocations";
+    }
+    return "unknown";
+}
+
+const char* MetricUnit(Metric metric) {
+    switch (metric) {
+        case Metric::kTickLatency:
+        case Metric::kRenderLatency:
+        case Metric::kInputLatency:
+            return "ns";
+        case Metric::kSnakeLength:
+            return "tiles";
+        case Metric::kAllocations:
+            return "allocs";
+    }
+    return "";
+}
+
+void Histogram::Clear() {
+    counts_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = 0;
+    max_ = 0;
+}
+
+std::uint64_t Histogram::BucketLowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    const int kShift = bucket / kSubBuckets - 1;
+    return static_cast<std::uint64_t>(kSubBuckets + bucket % kSubBuckets)
+           << kShift;
+}
+
+std::uint64_t Histogram::BucketUpperBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    const int kShift = bucket / kSubBuckets - 1;
+    return BucketLowerBound(bucket) + ((std::uint64_t{1} << kShift) - 1);
+}
+
+std::uint64_t Histogram::GetValueAtQuantile(double quantile) const {
+    if (!count_) {
+        return 0;
+    }
+
+    /* the rank of the sample at the quantile, counting from 1 */
+    const double kClamped = std::min(1.0, std::max(0.0, quantile));
+    const auto kRank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(kClamped * count_ + 0.5));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += counts_[i];
+        if (seen >= kRank) {
+            return std::min(std::max(BucketUpperBound(i), min_), max_);
+        }
+    }
+    return max_;
+}
+
+Recorder::~Recorder() {
+    if (socket_fd_ >= 0) {
+        FlushLocked();
+        close(socket_fd_);
+    }
+}
+
+void Recorder::Record(Metric metric, std::uint64_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordLocked(metric, value);
+}
+
+void Recorder::RecordLocked(Metric metric, std::uint64_t value) {
+    histograms_[static_cast<int>(metric)].Record(value);
+    if (socket_fd_ < 0) {
+        return;
+    }
+
+    /* a line is at most a name, a comma, 20 digits and a newline */
+    const std::size_t kMaxLine = 48;
+    if ((buffer_len_ + kMaxLine) > kBufferSize) {
+        FlushLocked();
+        if ((buffer_len_ + kMaxLine) > kBufferSize) {
+            num_dropped_++;
+            return;
+        }
+    }
+    const int kLen = std::snprintf(
+        buffer_.data() + buffer_len_, kBufferSize - buffer_len_, "%s,%llu\n",
+        MetricName(metric), static_cast<unsigned long long>(value));
+    if (kLen > 0) {
+        buffer_len_ += static_cast<std::size_t>(kLen);
+    }
+}
+
+bool Recorder::ConnectSocket(const char* path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strcpy(address.sun_path, path);
+
+    const int kFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (kFd < 0) {
+        return false;
+    }
+    if (connect(kFd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) < 0) {
+        close(kFd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_fd_ >= 0) {
+        close(socket_fd_);
+    }
+    socket_fd_ = kFd;
+    buffer_len_ = 0;
+    return true;
+}
+
+void Recorder::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+}
+
+void Recorder::FlushLocked() {
+    if ((socket_fd_ < 0) || !buffer_len_) {
+        return;
+    }
+
+    /* never block the game, whatever the socket does not take now stays
+     * buffered for the next flush */
+    const ssize_t kSent = send(socket_fd_, buffer_.data(), buffer_len_,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (kSent < 0) {
+        if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+            /* the listener went away, stop streaming */
+            close(socket_fd_);
+            socket_fd_ = -1;
+            buffer_len_ = 0;
+        }
+        return;
+    }
+    buffer_len_ -= static_cast<std::size_t>(kSent);
+    std::memmove(buffer_.data(), buffer_.data() + kSent, buffer_len_);
+}
+
+void Recorder::EndFrame() {
+    /* allocations are only counted in builds linking the hooks */
+#ifdef SNAKE_METRICS
+    const std::uint64_t kAllocations = GetNumAllocations();
+#else
+    const std::uint64_t kAllocations = 0;
+#endif
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_frame_) {
+        RecordLocked(Metric::kAllocations, kAllocations - frame_allocations_);
+    }
+    in_frame_ = true;
+    frame_allocations_ = kAllocations;
+    FlushLocked();
+}
+
+bool Recorder::WriteJson(std::ostream& os) const {
+    const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const char* kQuantileNames[] = {"p50", "p90", "p99", "p999"};
+
+    os << "{\n  \"metrics\": [";
+    for (int i = 0; i < kNumMetrics; ++i) {
+        const Metric kMetric = static_cast<Metric>(i);
+        const Histogram& histogram = histograms_[i];
+        os << (i ? ",\n" : "\n") << "    {\"name\": \"" << MetricName(kMetric)
+           << "\", \"unit\": \"" << MetricUnit(kMetric)
+           << "\", \"count\": " << histogram.GetCount()
+           << ", \"min\": " << histogram.GetMin()
+           << ", \"max\": " << histogram.GetMax()
+           << ", \"mean\": " << histogram.GetMean();
+        for (std::size_t j = 0; j < std::size(kQuantiles); ++j) {
+            os << ", \"" << kQuantileNames[j]
+               << "\": " << histogram.GetValueAtQuantile(kQuantiles[j]);
+        }
+
+        /* buckets as [lower bound, upper bound, count] */
+        os << ",\n     \"buckets\": [";
+        bool first = true;
+        for (int j = 0; j < Histogram::kNumBuckets; ++j) {
+            if (!histogram.GetBucketCount(j)) {
+                continue;
+            }
+            os << (first ? "" : ", ") << "["
+               << Histogram::BucketLowerBound(j) << ", "
+               << Histogram::BucketUpperBound(j) << ", "
+               << histogram.GetBucketCount(j) << "]";
+            first = false;
+        }
+        os << "]}";
+    }
+    os << "\n  ],\n  \"dropped\": " << num_dropped_ << "\n}\n";
+    return static_cast<bool>(os);
+}
+
+bool Recorder::WriteCsv(std::ostream& os) const {
+    os << "metric,unit,count,min,max,mean,p50,p90,p99,p999\n";
+    for (int i = 0; i < kNumMetrics; ++i) {
+        const Metric kMetric = static_cast<Metric>(i);
+        const Histogram& histogram = histograms_[i];
+        os << MetricName(kMetric) << ',' << MetricUnit(kMetric) << ','
+           << histogram.GetCount() << ',' << histogram.GetMin() << ','
+           << histogram.GetMax() << ',' << histogram.GetMean() << ','
+           << histogram.GetValueAtQuantile(0.5) << ','
+           << histogram.GetValueAtQuantile(0.9) << ','
+           << histogram.GetValueAtQuantile(0.99) << ','
+           << histogram.GetValueAtQuantile(0.999) << '\n';
+    }
+    return static_cast<bool>(os);
+}
+
+Recorder& GlobalRecorder() {
+    static Recorder recorder;
+    return recorder;
+}
+
+}  // namespace metrics
+}  // namespace snake
@@ -0,0 +1,329 @@
+#include "net/protocol.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace snake {
+namespace net {
+
+using snake::game::Direction;
+using snake::game::Tile;
+
+/* the first byte of a snapshot, delta bytes always have the top bit clear */
+static const std::uint8_t kSnapshotTag = 0x80;
+
+/* bits of a delta byte, the low three bits hold the head's direction */
+static const std::uint8_t kDirectionMask = 0x07;
+static const std::uint8_t kGrewBit = 0x08;
+static const std::uint8_t kTargetMovedBit = 0x10;
+static const std::uint8_t kGameOverBit = 0x20;
+static const std::uint8_t kDeltaMask =
+    kDirectionMask | kGrewBit | kTargetMovedBit | kGameOverBit;
+
+/* an encoded value is at most 64 bits wide, i.e., ten 7 bit groups */
+static const int kMaxVarintBytes = 10;
+
+/* refuse boards no terminal could show, which keeps every Tile within reach
+ * of a PackedTile */
+static const std::uint64_t kMaxSide = snake::game::kMaxPackedCoordinate;
+
+/* the snake is sized by the Tiles received rather than by the board, so a
+ * bad stream cannot make the view allocate more than it was sent */
+static const std::size_t kInitialCapacity = 16;
+
+static void PutVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/* a head which ended the game may lie off the board, so coordinates are
+ * zigzag encoded to keep small negative values short */
+static void PutCoordinate(std::vector<std::uint8_t>& out, int value) {
+    const auto kValue = static_cast<std::int64_t>(value);
+    PutVarint(out, (static_cast<std::uint64_t>(kValue) << 1) ^
+                       static_cast<std::uint64_t>(kValue >> 63));
+}
+
+/**
+ * Read a variable length integer from [pos, end), advancing pos past it.
+ *
+ * @returns 0 if the integer is incomplete, kMalformed if it is too long and
+ * 1 otherwise.
+ */
+static int GetVarint(const std::uint8_t*& pos, const std::uint8_t* end,
+                     std::uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < kMaxVarintBytes; ++i) {
+        if (pos == end) {
+            return 0;
+        }
+        const std::uint8_t kByte = *pos++;
+        value |= static_cast<std::uint64_t>(kByte & 0x7f) << (7 * i);
+        if (!(kByte & 0x80)) {
+            return 1;
+        }
+    }
+    return -1;
+}
+
+static int GetCoordinate(const std::uint8_t*& pos, const std::uint8_t* end,
+                         int& value) {
+    std::uint64_t encoded = 0;
+    const int kStatus = GetVarint(pos, end, encoded);
+    if (kStatus <= 0) {
+        return kStatus;
+    }
+    const std::int64_t kValue = static_cast<std::int64_t>(encoded >> 1) ^
+                                -static_cast<std::int64_t>(encoded & 1);
+    if ((kValue < -static_cast<std::int64_t>(kMaxSide)) ||
+        (kValue > static_cast<std::int64_t>(kMaxSide))) {
+        return -1;
+    }
+    value = static_cast<int>(kValue);
+    return 1;
+}
+
+void EncodeSnapshot(const snake::game::SnakeGame& game,
+                    std::vector<std::uint8_t>& out) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    const snake::game::Snake& snake = game.GetSnake();
+    out.push_back(kSnapshotTag);
+    PutVarint(out, static_cast<std::uint64_t>(game.GetTicks()));
+    PutVarint(out, static_cast<std::uint64_t>(kDim.width));
+    PutVarint(out, static_cast<std::uint64_t>(kDim.height));
+    PutVarint(out, static_cast<std::uint64_t>(game.GetBorder()));
+    PutVarint(out, static_cast<std::uint64_t>(game.GetScore()));
+    out.push_back(game.GameOver() ? 1 : 0);
+    PutCoordinate(out, game.GetTargetTile().row);
+    PutCoordinate(out, game.GetTargetTile().col);
+    PutVarint(out, snake.size());
+    PutCoordinate(out, snake.front().row);
+    PutCoordinate(out, snake.front().col);
+
+    /* two Tile directions per byte, the first in the low nibble */
+    for (std::size_t i = 0; i < snake.size(); i += 2) {
+        std::uint8_t byte = static_cast<std::uint8_t>(snake[i].direction);
+        if ((i + 1) < snake.size()) {
+            byte |= static_cast<std::uint8_t>(snake[i + 1].direction) << 4;
+        }
+        out.push_back(byte);
+    }
+}
+
+void EncodeDelta(const snake::game::SnakeGame& game,
+                 std::vector<std::uint8_t>& out) {
+    const snake::game::TickDelta& delta = game.GetLastDelta();
+    std::uint8_t byte = static_cast<std::uint8_t>(delta.head.direction);
+    if (!delta.tail_vacated) {
+        byte |= kGrewBit;
+    }
+    if (delta.target_moved) {
+        byte |= kTargetMovedBit;
+    }
+    if (game.GameOver()) {
+        byte |= kGameOverBit;
+    }
+    out.push_back(byte);
+
+    if (!delta.tail_vacated) {
+        PutVarint(out, static_cast<std::uint64_t>(game.GetScore()));
+    }
+    if (delta.target_moved) {
+        PutCoordinate(out, game.GetTargetTile().row);
+        PutCoordinate(out, game.GetTargetTile().col);
+    }
+}
+
+bool SpectatorView::Feed(const std::uint8_t* data, std::size_t len) {
+    /* decode straight from the parameter bytes unless part of a frame is
+     * already waiting */
+    const std::uint8_t* bytes = data;
+    if (!pending_.empty()) {
+        pending_.insert(pending_.end(), data, data + len);
+        bytes = pending_.data();
+        len = pending_.size();
+    }
+
+    std::size_t pos = 0;
+    while (pos < len) {
+        const std::ptrdiff_t kSize = DecodeFrame(bytes + pos, len - pos);
+        if (kMalformed == kSize) {
+            return false;
+        }
+        if (!kSize) {
+            break;
+        }
+        pos += static_cast<std::size_t>(kSize);
+        num_frames_++;
+    }
+
+    if (pending_.empty()) {
+        pending_.assign(data + pos, data + len);
+    } else {
+        pending_.erase(pending_.begin(),
+                       pending_.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+    return true;
+}
+
+std::ptrdiff_t SpectatorView::DecodeFrame(const std::uint8_t* data,
+                                          std::size_t len) {
+    if (kSnapshotTag == data[0]) {
+        return DecodeSnapshot(data, len);
+    }
+    if (data[0] & ~kDeltaMask) {
+        return kMalformed;
+    }
+    return DecodeDelta(data, len);
+}
+
+std::ptrdiff_t SpectatorView::DecodeSnapshot(const std::uint8_t* data,
+                                             std::size_t len) {
+    const std::uint8_t* pos = data + 1;
+    const std::uint8_t* end = data + len;
+
+    /* read the fixed fields before touching the view */
+    std::uint64_t fields[5] = {}; /* ticks, width, height, border, score */
+    for (std::uint64_t& field : fields) {
+        const int kStatus = GetVarint(pos, end, field);
+        if (kStatus <= 0) {
+            return kStatus;
+        }
+    }
+    const std::uint64_t kWidth = fields[1];
+    const std::uint64_t kHeight = fields[2];
+    if (!kWidth || !kHeight || (kWidth > kMaxSide) || (kHeight > kMaxSide) ||
+        (2 * fields[3] >= std::min(kWidth, kHeight)) ||
+        (fields[0] > static_cast<std::uint64_t>(INT64_MAX)) ||
+        (fields[4] > static_cast<std::uint64_t>(INT32_MAX))) {
+        return kMalformed;
+    }
+
+    if (pos == end) {
+        return 0;
+    }
+    const std::uint8_t kGameOver = *pos++;
+    if (kGameOver > 1) {
+        return kMalformed;
+    }
+
+    Tile target;
+    Tile head;
+    std::uint64_t length = 0;
+    int status = GetCoordinate(pos, end, target.row);
+    status = (status > 0) ? GetCoordinate(pos, end, target.col) : status;
+    status = (status > 0) ? GetVarint(pos, end, length) : status;
+    status = (status > 0) ? GetCoordinate(pos, end, head.row) : status;
+    status = (status > 0) ? GetCoordinate(pos, end, head.col) : status;
+    if (status <= 0) {
+        return status;
+    }
+
+    /* a snake which lost by running into itself holds one Tile more than
+     * there is room for on the board */
+    const std::uint64_t kNumCells = kWidth * kHeight;
+    if (!length || (length > kNumCells + 1)) {
+        return kMalformed;
+    }
+    const std::uint64_t kDirectionBytes = (length + 1) / 2;
+    if (static_cast<std::uint64_t>(end - pos) < kDirectionBytes) {
+        return 0;
+    }
+
+    has_game_ = true;
+    ticks_ = static_cast<std::int64_t>(fields[0]);
+    screen_dim_ = {.width = static_cast<int>(kWidth),
+                   .height = static_cast<int>(kHeight)};
+    border_ = static_cast<int>(fields[3]);
+    score_ = static_cast<int>(fields[4]);
+    game_over_ = kGameOver;
+    target_ = target;
+    if (snake_.capacity() < length) {
+        snake_.Reset(std::max<std::size_t>(kInitialCapacity, length));
+    }
+    snake_.clear();
+
+    /* each Tile was entered moving in its direction, so stepping against it
+     * leads to the next Tile towards the tail */
+    Tile tile = head;
+    for (std::uint64_t i = 0; i < length; ++i) {
+        const std::uint8_t kNibble = (pos[i / 2] >> (4 * (i % 2))) & 0x0f;
+        if (kNibble >= static_cast<std::uint8_t>(Direction::kNone)) {
+            return kMalformed;
+        }
+        if (i) {
+            tile = Neighbor(tile, Opposite(tile.direction));
+        }
+        tile.direction = static_cast<Direction>(kNibble);
+        snake_.push_back(tile);
+    }
+    num_snapshots_++;
+
+    return (pos - data) + static_cast<std::ptrdiff_t>(kDirectionBytes);
+}
+
+std::ptrdiff_t SpectatorView::DecodeDelta(const std::uint8_t* data,
+                                          std::size_t len) {
+    const std::uint8_t kByte = data[0];
+    const std::uint8_t kDirection = kByte & kDirectionMask;
+    const bool kGrew = kByte & kGrewBit;
+    const auto kNumCells =
+        static_cast<std::size_t>(screen_dim_.width * screen_dim_.height);
+    if (!has_game_ || game_over_ ||
+        (kDirection >= static_cast<std::uint8_t>(Direction::kNone)) ||
+        (kGrew && (snake_.size() > kNumCells))) {
+        return kMalformed;
+    }
+
+    const std::uint8_t* pos = data + 1;
+    const std::uint8_t* end = data + len;
+    std::uint64_t score = static_cast<std::uint64_t>(score_);
+    Tile target = target_;
+    int status = 1;
+    if (kGrew) {
+        status = GetVarint(pos, end, score);
+    }
+    if ((status > 0) && (kByte & kTargetMovedBit)) {
+        status = GetCoordinate(pos, end, target.row);
+        status = (status > 0) ? GetCoordinate(pos, end, target.col) : status;
+    }
+    if (status <= 0) {
+        return status;
+    }
+    if (score > static_cast<std::uint64_t>(INT32_MAX)) {
+        return kMalformed;
+    }
+
+    /* grow the snake by doubling like MultiSnakeGame does, at most to the
+     * Tiles a snake can cover */
+    if (kGrew && snake_.full()) {
+        snake_.Grow(std::min(
+            std::max(kInitialCapacity, 2 * snake_.capacity()), kNumCells + 1));
+    }
+
+    /* move the snake the way SnakeGame::MoveSnake() and, if it grew,
+     * SnakeGame::ExtendSnake() do */
+    const auto kHeadDirection = static_cast<Direction>(kDirection);
+    Tile head = Neighbor(snake_.front(), kHeadDirection);
+    head.direction = kHeadDirection;
+    snake_.pop_back();
+    snake_.push_front(head);
+    if (kGrew) {
+        const Tile& tail = snake_.back();
+        snake_.push_back(Neighbor(tail, Opposite(tail.direction)));
+    }
+
+    ticks_++;
+    score_ = static_cast<int>(score);
+    target_ = target;
+    game_over_ = kByte & kGameOverBit;
+
+    return pos - data;
+}
+
+}  // namespace net
+}  // namespace snake
@@ -0,0 +1,205 @@
+#include "net/server.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include "net/protocol.hpp"
+#include "net/socket.hpp"
+
+namespace snake {
+namespace net {
+
+SpectatorServer::SpectatorServer(std::size_t max_lag) : max_lag_(max_lag) {}
+
+SpectatorServer::~SpectatorServer() {
+    for (const Spectator& spectator : spectators_) {
+        close(spectator.fd);
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+    }
+    if (!unix_path_.empty()) {
+        unlink(unix_path_.c_str());
+    }
+}
+
+bool SpectatorServer::Listen(const char* address) {
+    const int kFd = OpenListener(address);
+    if (kFd < 0) {
+        return false;
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+    }
+    listen_fd_ = kFd;
+
+    sockaddr_storage storage = {};
+    socklen_t storage_len = sizeof(storage);
+    getsockname(kFd, reinterpret_cast<sockaddr*>(&storage), &storage_len);
+    unix_path_ = (AF_UNIX == storage.ss_family) ? address : "";
+    return true;
+}
+
+void SpectatorServer::Broadcast(const snake::game::SnakeGame& game) {
+    /* spectators that join later start from a snapshot */
+    if (spectators_.empty()) {
+        return;
+    }
+    frame_starts_.push_back(LogEnd());
+    EncodeDelta(game, log_);
+}
+
+void SpectatorServer::BroadcastSnapshot(const snake::game::SnakeGame& game) {
+    if (spectators_.empty()) {
+        return;
+    }
+    frame_starts_.push_back(LogEnd());
+    EncodeSnapshot(game, log_);
+}
+
+void SpectatorServer::Update(const snake::game::SnakeGame& game) {
+    AcceptSpectators(game);
+
+    std::size_t i = 0;
+    while (i < spectators_.size()) {
+        Spectator& spectator = spectators_[i];
+        bool keep = true;
+        if ((LogEnd() - spectator.offset) > max_lag_) {
+            if (spectator.direct_sent < spectator.direct.size()) {
+                keep = false; /* still behind on the last snapshot */
+            } else {
+                Resync(spectator, game);
+            }
+        }
+        keep = keep && Send(spectator);
+
+        if (keep) {
+            ++i;
+            continue;
+        }
+        close(spectator.fd);
+        num_dropped_++;
+        std::swap(spectator, spectators_.back());
+        spectators_.pop_back();
+    }
+
+    TrimLog();
+}
+
+void SpectatorServer::AcceptSpectators(const snake::game::SnakeGame& game) {
+    if (listen_fd_ < 0) {
+        return;
+    }
+
+    int fd = -1;
+    while ((fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK)) >= 0) {
+        if (unix_path_.empty()) {
+            /* frames are already batched, don't hold them back any longer */
+            const int kNoDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &kNoDelay,
+                       sizeof(kNoDelay));
+        }
+        Spectator spectator;
+        spectator.fd = fd;
+        spectator.offset = LogEnd();
+        EncodeSnapshot(game, spectator.direct);
+        spectators_.push_back(std::move(spectator));
+    }
+}
+
+void SpectatorServer::Resync(Spectator& spectator,
+                             const snake::game::SnakeGame& game) {
+    spectator.direct.clear();
+    spectator.direct_sent = 0;
+
+    /* a frame the socket took part of has to be finished first */
+    auto next = std::upper_bound(frame_starts_.begin(), frame_starts_.end(),
+                                 spectator.offset);
+    const bool kMidFrame = (spectator.offset != LogEnd()) &&
+                           (*(next - 1) != spectator.offset);
+    if (kMidFrame) {
+        const std::uint64_t kFrameEnd =
+            (next == frame_starts_.end()) ? LogEnd() : *next;
+        spectator.direct.assign(
+            log_.begin() +
+                static_cast<std::ptrdiff_t>(spectator.offset - log_base_),
+            log_.begin() + static_cast<std::ptrdiff_t>(kFrameEnd - log_base_));
+    }
+
+    EncodeSnapshot(game, spectator.direct);
+    spectator.offset = LogEnd();
+    num_resyncs_++;
+}
+
+bool SpectatorServer::Send(Spectator& spectator) {
+    const std::size_t kDirectLen =
+        spectator.direct.size() - spectator.direct_sent;
+    const std::size_t kLogLen =
+        static_cast<std::size_t>(LogEnd() - spectator.offset);
+    if (!kDirectLen && !kLogLen) {
+        return true;
+    }
+
+    iovec parts[2] = {
+        {.iov_base = spectator.direct.data() + spectator.direct_sent,
+         .iov_len = kDirectLen},
+        {.iov_base = log_.data() + (spectator.offset - log_base_),
+         .iov_len = kLogLen},
+    };
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+
+    /* never block the game, whatever the socket does not take now is sent
+     * with the next update */
+    const ssize_t kSent =
+        sendmsg(spectator.fd, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (kSent < 0) {
+        return (EAGAIN == errno) || (EWOULDBLOCK == errno);
+    }
+
+    auto sent = static_cast<std::size_t>(kSent);
+    bytes_sent_ += sent;
+    const std::size_t kFromDirect = std::min(sent, kDirectLen);
+    spectator.direct_sent += kFromDirect;
+    spectator.offset += sent - kFromDirect;
+    if (spectator.direct_sent == spectator.direct.size()) {
+        spectator.direct.clear();
+        spectator.direct_sent = 0;
+    }
+    return true;
+}
+
+void SpectatorServer::TrimLog() {
+    std::uint64_t min_offset = LogEnd();
+    for (const Spectator& spectator : spectators_) {
+        min_offset = std::min(min_offset, spectator.offset);
+    }
+
+    /* erasing only once at least half of the log has been sent keeps the
+     * cost of moving the rest down constant per byte */
+    const auto kSent = static_cast<std::size_t>(min_offset - log_base_);
+    if (!kSent || ((2 * kSent) < log_.size())) {
+        return;
+    }
+    log_.erase(log_.begin(), log_.begin() + static_cast<std::ptrdiff_t>(kSent));
+    log_base_ = min_offset;
+
+    /* keep the start of a frame the socket took only part of, see Resync() */
+    auto first = std::upper_bound(frame_starts_.begin(), frame_starts_.end(),
+                                  min_offset);
+    if ((first != frame_starts_.begin()) && (min_offset != LogEnd())) {
+        --first;
+    }
+    frame_starts_.erase(frame_starts_.begin(), first);
+}
+
+}  // namespace net
+}  // namespace snake
@@ -0,0 +1,103 @@
+#include "net/socket.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace snake {
+namespace net {
+
+/** Parse a TCP port number, returning -1 if address is not one. */
+static int ParsePort(const char* address) {
+    char* end = nullptr;
+    const long kPort = std::strtol(address, &end, 10);
+    if (!*address || *end || (kPort < 1) || (kPort > 65535)) {
+        return -1;
+    }
+    return static_cast<int>(kPort);
+}
+
+/**
+ * Create a socket for the parameter address and fill in its sockaddr.
+ *
+ * @returns The socket's descriptor or -1 on failure.
+ */
+static int CreateSocket(const char* address, sockaddr_storage& storage,
+                        socklen_t& storage_len) {
+    storage = {};
+    const int kPort = ParsePort(address);
+    if (kPort > 0) {
+        auto* inet = reinterpret_cast<sockaddr_in*>(&storage);
+        inet->sin_family = AF_INET;
+        inet->sin_port = htons(static_cast<std::uint16_t>(kPort));
+        inet->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        storage_len = sizeof(sockaddr_in);
+        return socket(AF_INET, SOCK_STREAM, 0);
+    }
+
+    auto* local = reinterpret_cast<sockaddr_un*>(&storage);
+    if (std::strlen(address) >= sizeof(local->sun_path)) {
+        return -1;
+    }
+    local->sun_family = AF_UNIX;
+    std::strcpy(local->sun_path, address);
+    storage_len = sizeof(sockaddr_un);
+    return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+int OpenListener(const char* address) {
+    sockaddr_storage storage;
+    socklen_t storage_len = 0;
+    const int kFd = CreateSocket(address, storage, storage_len);
+    if (kFd < 0) {
+        return -1;
+    }
+
+    if (AF_INET == storage.ss_family) {
+        const int kReuse = 1;
+        setsockopt(kFd, SOL_SOCKET, SO_REUSEADDR, &kReuse, sizeof(kReuse));
+    } else {
+        /* only ever remove a socket, never a regular file at the path */
+        struct stat status;
+        if ((0 == stat(address, &status)) && S_ISSOCK(status.st_mode)) {
+            unlink(address);
+        }
+    }
+
+    /* a backlog large enough for hundreds of spectators joining at once */
+    const int kBacklog = 512;
+    if ((bind(kFd, reinterpret_cast<const sockaddr*>(&storage), storage_len) <
+         0) ||
+        (listen(kFd, kBacklog) < 0) ||
+        (fcntl(kFd, F_SETFL, fcntl(kFd, F_GETFL) | O_NONBLOCK) < 0)) {
+        close(kFd);
+        return -1;
+    }
+    return kFd;
+}
+
+int OpenConnection(const char* address) {
+    sockaddr_storage storage;
+    socklen_t storage_len = 0;
+    const int kFd = CreateSocket(address, storage, storage_len);
+    if (kFd < 0) {
+        return -1;
+    }
+    if (connect(kFd, reinterpret_cast<const sockaddr*>(&storage),
+                storage_len) < 0) {
+        close(kFd);
+        return -1;
+    }
+    return kFd;
+}
+
+}  // namespace net
+}  // namespace snake
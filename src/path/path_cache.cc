@@ -0,0 +1,172 @@
+#include "path/path_cache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace snake {
+namespace path {
+
+using snake::game::Direction;
+using snake::game::SnakeGame;
+using snake::game::Tile;
+
+void PathCache::Resize(const SnakeGame& game) {
+    screen_dim_ = game.GetScreenDimension();
+    const auto kNumCells =
+        static_cast<std::size_t>(screen_dim_.width * screen_dim_.height);
+    search_ = 0;
+    seen_.assign(kNumCells, 0);
+    closed_.assign(kNumCells, 0);
+    cost_.assign(kNumCells, 0);
+    parent_.assign(kNumCells, kNoCell);
+    frontier_.reserve(kNumCells);
+    next_frontier_.reserve(kNumCells);
+    path_.reserve(kNumCells);
+    path_.clear();
+}
+
+bool PathCache::NextDirection(const SnakeGame& game, Direction& direction) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    if ((kDim.width != screen_dim_.width) ||
+        (kDim.height != screen_dim_.height)) {
+        Resize(game);
+    }
+
+    const Tile& head = game.GetSnake().front();
+    if (!game.IsInBounds(head)) {
+        return false;
+    }
+    const int kHead = CellIndex(head.row, head.col);
+
+    /* keep the path if it still leads to the target, the head took its last
+     * step along it and the step after that is still free */
+    bool valid = !path_.empty() && (game.GetTargetTile() == target_);
+    if (valid && (kHead != path_[head_index_])) {
+        head_index_++;
+        valid = (head_index_ < path_.size()) && (kHead == path_[head_index_]);
+    }
+    valid = valid && ((head_index_ + 1) < path_.size()) &&
+            game.IsFree({.row = path_[head_index_ + 1] / screen_dim_.width,
+                         .col = path_[head_index_ + 1] % screen_dim_.width});
+
+    if (!valid) {
+        /* after a failed search, give the tail time to uncover more of the
+         * board unless the target moved */
+        const bool kSameTarget = (game.GetTargetTile() == target_);
+        if (path_.empty() && kSameTarget && (game.GetTicks() < retry_tick_)) {
+            return false;
+        }
+        if (!Plan(game)) {
+            path_.clear();
+            if (!kSameTarget) {
+                retry_backoff_ = 1;
+            }
+            retry_tick_ = game.GetTicks() + retry_backoff_;
+            retry_backoff_ = std::min(2 * retry_backoff_, kMaxRetryBackoff);
+            return false;
+        }
+        retry_backoff_ = 1;
+    }
+
+    const int kNext = path_[head_index_ + 1];
+    if (kNext == (kHead - screen_dim_.width)) {
+        direction = Direction::kUp;
+    } else if (kNext == (kHead + screen_dim_.width)) {
+        direction = Direction::kDown;
+    } else if (kNext == (kHead - 1)) {
+        direction = Direction::kLeft;
+    } else {
+        direction = Direction::kRight;
+    }
+    return true;
+}
+
+bool PathCache::Plan(const SnakeGame& game) {
+    num_plans_++;
+    target_ = game.GetTargetTile();
+    const Tile& head = game.GetSnake().front();
+    const int kStart = CellIndex(head.row, head.col);
+    const int kGoal = CellIndex(target_.row, target_.col);
+    auto heuristic = [this](int row, int col) {
+        return std::abs(row - target_.row) + std::abs(col - target_.col);
+    };
+
+    /* start a new search, the stamps only need clearing when they wrap */
+    if (0 == ++search_) {
+        std::fill(seen_.begin(), seen_.end(), 0);
+        std::fill(closed_.begin(), closed_.end(), 0);
+        search_ = 1;
+    }
+    seen_[kStart] = search_;
+    cost_[kStart] = 0;
+    parent_[kStart] = kNoCell;
+
+    /* the Manhattan heuristic is consistent and changes by one per step, so
+     * a step either keeps the estimated total cost or raises it by two and
+     * two stacks take the place of a priority queue */
+    frontier_.clear();
+    next_frontier_.clear();
+    frontier_.push_back(kStart);
+    int bound = heuristic(head.row, head.col);
+    bool found = false;
+    while (!found) {
+        if (frontier_.empty()) {
+            if (next_frontier_.empty()) {
+                return false;
+            }
+            std::swap(frontier_, next_frontier_);
+            bound += 2;
+            continue;
+        }
+
+        const int kCell = frontier_.back();
+        frontier_.pop_back();
+        if (search_ == closed_[kCell]) {
+            continue; /* already expanded at a lower cost */
+        }
+        closed_[kCell] = search_;
+        num_expanded_++;
+        if (kGoal == kCell) {
+            found = true;
+            continue;
+        }
+
+        const Tile kTile = {.row = kCell / screen_dim_.width,
+                            .col = kCell % screen_dim_.width};
+        const Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                         Direction::kLeft, Direction::kRight};
+        for (const Direction& direction : kDirections) {
+            const Tile kNeighbor = Neighbor(kTile, direction);
+            if (!game.IsFree(kNeighbor)) {
+                continue;
+            }
+            const int kNeighborCell = CellIndex(kNeighbor.row, kNeighbor.col);
+            const int kCost = cost_[kCell] + 1;
+            if ((search_ == closed_[kNeighborCell]) ||
+                ((search_ == seen_[kNeighborCell]) &&
+                 (cost_[kNeighborCell] <= kCost))) {
+                continue;
+            }
+            seen_[kNeighborCell] = search_;
+            cost_[kNeighborCell] = kCost;
+            parent_[kNeighborCell] = kCell;
+            if ((kCost + heuristic(kNeighbor.row, kNeighbor.col)) == bound) {
+                frontier_.push_back(kNeighborCell);
+            } else {
+                next_frontier_.push_back(kNeighborCell);
+            }
+        }
+    }
+
+    path_.clear();
+    for (int cell = kGoal; kNoCell != cell; cell = parent_[cell]) {
+        path_.push_back(cell);
+    }
+    std::reverse(path_.begin(), path_.end());
+    head_index_ = 0;
+    return true;
+}
+
+}  // namespace path
+}  // namespace snake
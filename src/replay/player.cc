@@ -0,0 +1,110 @@
+#include "replay/player.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace snake {
+namespace replay {
+
+ReplayPlayer::ReplayPlayer(const Replay& replay,
+                           std::int64_t checkpoint_interval)
+    : replay_(replay),
+      checkpoint_interval_(std::max<std::int64_t>(1, checkpoint_interval)),
+      game_(replay.dim, replay.border, snake::game::Rng(replay.seed)),
+      tick_(0) {
+    std::int64_t end = 0;
+    for (const Run& run : replay_.runs) {
+        end += run.ticks;
+        run_ends_.push_back(end);
+    }
+    ApplyResizes(0);
+    checkpoints_.push_back(game_);
+}
+
+void ReplayPlayer::Seek(std::int64_t tick) {
+    tick = std::clamp<std::int64_t>(tick, 0, NumTicks());
+
+    /* restart from the closest checkpoint unless playing forward from the
+     * current tick is at least as close */
+    const auto kCheckpoint = std::min(
+        static_cast<std::size_t>(tick / checkpoint_interval_),
+        checkpoints_.size() - 1);
+    const std::int64_t kCheckpointTick =
+        static_cast<std::int64_t>(kCheckpoint) * checkpoint_interval_;
+    if ((tick < tick_) || (kCheckpointTick > tick_)) {
+        game_ = checkpoints_[kCheckpoint];
+        tick_ = kCheckpointTick;
+    }
+
+    PlayTo(tick);
+}
+
+void ReplayPlayer::PlayTo(std::int64_t tick) {
+    /* first run which has not been played in full and first resize which
+     * has not been applied */
+    auto run = static_cast<std::size_t>(
+        std::upper_bound(run_ends_.begin(), run_ends_.end(), tick_) -
+        run_ends_.begin());
+    auto resize = static_cast<std::size_t>(
+        std::upper_bound(replay_.resizes.begin(), replay_.resizes.end(), tick_,
+                         [](std::int64_t t, const Resize& r) {
+                             return (t < r.tick);
+                         }) -
+        replay_.resizes.begin());
+
+    while (tick_ < tick) {
+        /* every tick before the next checkpoint has been played, see Seek() */
+        const std::int64_t kNextCheckpoint =
+            static_cast<std::int64_t>(checkpoints_.size()) *
+            checkpoint_interval_;
+        const std::int64_t kNextResize = (resize < replay_.resizes.size())
+                                             ? replay_.resizes[resize].tick
+                                             : tick;
+        const std::int64_t kStop =
+            std::min({tick, run_ends_[run], kNextCheckpoint, kNextResize});
+        const snake::game::Direction kDirection = replay_.runs[run].direction;
+        for (; tick_ < kStop; ++tick_) {
+            game_.Tick(kDirection);
+        }
+
+        if (tick_ == run_ends_[run]) {
+            run++;
+        }
+        resize = ApplyResizes(resize);
+        if (tick_ == kNextCheckpoint) {
+            /* thinning a full set keeps the even checkpoints, the current
+             * tick then falls on the next checkpoint at the doubled
+             * interval */
+            if (checkpoints_.size() == kMaxCheckpoints) {
+                ThinCheckpoints();
+            }
+            checkpoints_.push_back(game_);
+        }
+    }
+}
+
+void ReplayPlayer::ThinCheckpoints() {
+    const std::size_t kKept = (checkpoints_.size() + 1) / 2;
+    for (std::size_t i = 1; i < kKept; ++i) {
+        checkpoints_[i] = std::move(checkpoints_[2 * i]);
+    }
+    checkpoints_.erase(
+        checkpoints_.begin() + static_cast<std::ptrdiff_t>(kKept),
+        checkpoints_.end());
+    checkpoint_interval_ *= 2;
+}
+
+std::size_t ReplayPlayer::ApplyResizes(std::size_t resize) {
+    /* a valid replay only holds resizes which succeeded when recorded */
+    for (; (resize < replay_.resizes.size()) &&
+           (replay_.resizes[resize].tick == tick_);
+         ++resize) {
+        game_.Resize(replay_.resizes[resize].dim);
+    }
+    return resize;
+}
+
+}  // namespace replay
+}  // namespace snake
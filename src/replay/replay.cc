@@ -0,0 +1,196 @@
+#include "replay/replay.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+namespace snake {
+namespace replay {
+
+using snake::game::Direction;
+
+static const char kMagic[4] = {'S', 'N', 'K', 'R'};
+static const std::uint32_t kVersion = 1;
+
+/* the version which adds resizes, see WriteReplay() */
+static const std::uint32_t kResizeVersion = 2;
+
+/* bits of an encoded run holding its direction */
+static const int kDirectionBits = 3;
+
+/* an encoded run is at most 64 bits wide, i.e., ten 7 bit groups */
+static const int kMaxVarintBytes = 10;
+
+static void PutUint(std::ostream& os, std::uint64_t value, int num_bytes) {
+    for (int i = 0; i < num_bytes; ++i) {
+        os.put(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+static bool GetUint(std::istream& is, std::uint64_t& value, int num_bytes) {
+    value = 0;
+    for (int i = 0; i < num_bytes; ++i) {
+        int byte = is.get();
+        if (std::istream::traits_type::eof() == byte) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte) << (8 * i);
+    }
+    return true;
+}
+
+static void PutVarint(std::ostream& os, std::uint64_t value) {
+    while (value >= 0x80) {
+        os.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    os.put(static_cast<char>(value));
+}
+
+static bool GetVarint(std::istream& is, std::uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < kMaxVarintBytes; ++i) {
+        int byte = is.get();
+        if (std::istream::traits_type::eof() == byte) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << (7 * i);
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::int64_t Replay::NumTicks() const {
+    std::int64_t num_ticks = 0;
+    for (const Run& run : runs) {
+        num_ticks += run.ticks;
+    }
+    return num_ticks;
+}
+
+void Replay::Append(Direction direction) {
+    if (runs.empty() || (runs.back().direction != direction)) {
+        runs.push_back({.direction = direction, .ticks = 0});
+    }
+    runs.back().ticks++;
+}
+
+void Replay::AppendResize(const snake::game::ScreenDimension& new_dim) {
+    resizes.push_back({.tick = NumTicks(), .dim = new_dim});
+}
+
+/** Return true if a board of the parameter dimensions can be played on. */
+static bool IsValidBoard(std::uint64_t width, std::uint64_t height,
+                         std::uint64_t border) {
+    /* the board must have at least one playable tile and fit a PackedTile */
+    const std::uint64_t kMaxDim = snake::game::kMaxPackedCoordinate;
+    return (width <= kMaxDim) && (height <= kMaxDim) &&
+           ((2 * border) < std::min(width, height));
+}
+
+bool WriteReplay(std::ostream& os, const Replay& replay) {
+    /* replays without resizes stay readable by version 1 readers */
+    os.write(kMagic, sizeof(kMagic));
+    PutUint(os, replay.resizes.empty() ? kVersion : kResizeVersion, 4);
+    PutUint(os, replay.seed, 8);
+    PutUint(os, static_cast<std::uint32_t>(replay.dim.width), 4);
+    PutUint(os, static_cast<std::uint32_t>(replay.dim.height), 4);
+    PutUint(os, static_cast<std::uint32_t>(replay.border), 4);
+    PutUint(os, replay.runs.size(), 8);
+    for (const Run& run : replay.runs) {
+        const auto kTicks = static_cast<std::uint64_t>(run.ticks);
+        PutVarint(os, (kTicks << kDirectionBits) |
+                          static_cast<std::uint64_t>(run.direction));
+    }
+    if (!replay.resizes.empty()) {
+        PutVarint(os, replay.resizes.size());
+        for (const Resize& resize : replay.resizes) {
+            PutVarint(os, static_cast<std::uint64_t>(resize.tick));
+            PutVarint(os, static_cast<std::uint32_t>(resize.dim.width));
+            PutVarint(os, static_cast<std::uint32_t>(resize.dim.height));
+        }
+    }
+    return static_cast<bool>(os.flush());
+}
+
+bool ReadReplay(std::istream& is, Replay& replay) {
+    char magic[sizeof(kMagic)] = {};
+    if (!is.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), kMagic)) {
+        return false;
+    }
+
+    std::uint64_t version = 0;
+    std::uint64_t width = 0;
+    std::uint64_t height = 0;
+    std::uint64_t border = 0;
+    std::uint64_t num_runs = 0;
+    if (!GetUint(is, version, 4) ||
+        ((kVersion != version) && (kResizeVersion != version)) ||
+        !GetUint(is, replay.seed, 8) || !GetUint(is, width, 4) ||
+        !GetUint(is, height, 4) || !GetUint(is, border, 4) ||
+        !GetUint(is, num_runs, 8)) {
+        return false;
+    }
+
+    if (!IsValidBoard(width, height, border)) {
+        return false;
+    }
+    replay.dim = {.width = static_cast<int>(width),
+                  .height = static_cast<int>(height)};
+    replay.border = static_cast<int>(border);
+
+    /* don't trust the run count for the allocation size, the stream may be
+     * truncated */
+    replay.runs.clear();
+    const std::int64_t kMaxTicks = std::numeric_limits<std::int64_t>::max() >>
+                                   kDirectionBits;
+    std::int64_t num_ticks = 0;
+    for (std::uint64_t i = 0; i < num_runs; ++i) {
+        std::uint64_t value = 0;
+        if (!GetVarint(is, value)) {
+            return false;
+        }
+        const std::uint64_t kDirection =
+            value & ((1U << kDirectionBits) - 1);
+        const auto kTicks = static_cast<std::int64_t>(value >> kDirectionBits);
+        if ((kDirection > static_cast<std::uint64_t>(Direction::kNone)) ||
+            (0 == kTicks) || (kTicks > (kMaxTicks - num_ticks))) {
+            return false;
+        }
+        num_ticks += kTicks;
+        replay.runs.push_back(
+            {.direction = static_cast<Direction>(kDirection), .ticks = kTicks});
+    }
+
+    /* resizes come in order of their ticks, all within the game */
+    replay.resizes.clear();
+    std::uint64_t num_resizes = 0;
+    if ((kResizeVersion == version) && !GetVarint(is, num_resizes)) {
+        return false;
+    }
+    std::int64_t prev_tick = 0;
+    for (std::uint64_t i = 0; i < num_resizes; ++i) {
+        std::uint64_t tick = 0;
+        if (!GetVarint(is, tick) || !GetVarint(is, width) ||
+            !GetVarint(is, height) ||
+            (tick > static_cast<std::uint64_t>(num_ticks)) ||
+            (static_cast<std::int64_t>(tick) < prev_tick) ||
+            !IsValidBoard(width, height, border)) {
+            return false;
+        }
+        prev_tick = static_cast<std::int64_t>(tick);
+        replay.resizes.push_back(
+            {.tick = prev_tick,
+             .dim = {.width = static_cast<int>(width),
+                     .height = static_cast<int>(height)}});
+    }
+    return true;
+}
+
+}  // namespace replay
+}  // namespace snake
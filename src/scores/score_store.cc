@@ -0,0 +1,286 @@
+#include "scores/score_store.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <tuple>
+
+namespace snake {
+namespace scores {
+
+static const char kMagic[8] = {'S', 'N', 'K', 'S', 'C', 'O', 'R', 'E'};
+static const std::uint32_t kVersion = 1;
+
+/* records the file has room for when created */
+static const std::size_t kInitialCapacity = 1024;
+
+/* the records follow the header directly, which keeps them 8-byte aligned,
+ * all fields are in host byte order */
+struct FileHeader {
+    char magic[sizeof(kMagic)];
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t count; /**< Records appended, bumped after each append. */
+    std::uint64_t reserved;
+};
+
+static_assert((32 == sizeof(FileHeader)) &&
+                  (0 == sizeof(FileHeader) % alignof(GameRecord)),
+              "the records must be aligned within the mapping");
+
+/** Hold an exclusive lock on a file for the lifetime of the object. */
+class FileLock {
+   public:
+    explicit FileLock(int fd) : fd_(fd) {
+        int ret = 0;
+        do {
+            ret = flock(fd_, LOCK_EX);
+        } while ((-1 == ret) && (EINTR == errno));
+        locked_ = (0 == ret);
+    }
+    ~FileLock() {
+        if (locked_) {
+            flock(fd_, LOCK_UN);
+        }
+    }
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    bool IsLocked() const { return locked_; }
+
+   private:
+    int fd_;
+    bool locked_ = false;
+};
+
+ScoreStore::~ScoreStore() { Close(); }
+
+bool ScoreStore::Open(const std::string& path) {
+    Close();
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    /* the record count is only ever read or written under the lock, which
+     * also keeps two processes creating the file at once from both writing
+     * the header */
+    bool is_valid = false;
+    {
+        FileLock lock(fd_);
+        struct stat st = {};
+        is_valid = lock.IsLocked() && (0 == fstat(fd_, &st));
+        auto file_bytes = static_cast<std::size_t>(st.st_size);
+        if (is_valid && (0 == file_bytes)) {
+            FileHeader header = {};
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.record_size = sizeof(GameRecord);
+            file_bytes =
+                sizeof(header) + kInitialCapacity * sizeof(GameRecord);
+            is_valid = (0 == posix_fallocate(
+                                 fd_, 0, static_cast<off_t>(file_bytes))) &&
+                       (static_cast<ssize_t>(sizeof(header)) ==
+                        pwrite(fd_, &header, sizeof(header), 0));
+        }
+        is_valid = is_valid && (file_bytes >= sizeof(FileHeader)) &&
+                   Map(file_bytes) && IsValidHeader();
+        if (is_valid) {
+            LoadSize();
+        }
+    }
+    if (!is_valid) {
+        Close();
+    }
+    return is_valid;
+}
+
+bool ScoreStore::IsValidHeader() const {
+    const auto* header = static_cast<const FileHeader*>(map_);
+    return std::equal(header->magic, header->magic + sizeof(kMagic), kMagic) &&
+           (kVersion == header->version) &&
+           (sizeof(GameRecord) == header->record_size);
+}
+
+void ScoreStore::Close() {
+    if (map_) {
+        munmap(map_, map_bytes_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+    fd_ = -1;
+    map_ = nullptr;
+    map_bytes_ = 0;
+    capacity_ = 0;
+    size_ = 0;
+    records_ = nullptr;
+    best_scores_.clear();
+    num_indexed_ = 0;
+}
+
+bool ScoreStore::Map(std::size_t map_bytes) {
+    void* map = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fd_, 0);
+    if (MAP_FAILED == map) {
+        return false;
+    }
+    if (map_) {
+        munmap(map_, map_bytes_);
+    }
+    map_ = map;
+    map_bytes_ = map_bytes;
+    capacity_ = (map_bytes - sizeof(FileHeader)) / sizeof(GameRecord);
+    records_ = reinterpret_cast<GameRecord*>(static_cast<char*>(map_) +
+                                             sizeof(FileHeader));
+    return true;
+}
+
+bool ScoreStore::Grow() {
+    const std::size_t kCapacity = std::max(kInitialCapacity, 2 * capacity_);
+    const std::size_t kBytes =
+        sizeof(FileHeader) + kCapacity * sizeof(GameRecord);
+
+    /* reserve the disk blocks up front, writing to a mapped hole of a full
+     * disk would raise SIGBUS instead of failing here */
+    return (0 == posix_fallocate(fd_, 0, static_cast<off_t>(kBytes))) &&
+           Map(kBytes);
+}
+
+void ScoreStore::LoadSize() {
+    const std::uint64_t kCount = static_cast<const FileHeader*>(map_)->count;
+    size_ = static_cast<std::size_t>(
+        std::min<std::uint64_t>(kCount, capacity_));
+}
+
+bool ScoreStore::Append(const GameRecord& record) {
+    if (!IsOpen()) {
+        return false;
+    }
+    FileLock lock(fd_);
+    if (!lock.IsLocked()) {
+        return false;
+    }
+
+    /* another process may have grown the file, and a count past the end of
+     * the file can only come from a damaged header */
+    LoadSize();
+    if (size_ == capacity_) {
+        struct stat st = {};
+        if ((0 == fstat(fd_, &st)) &&
+            (static_cast<std::size_t>(st.st_size) > map_bytes_) &&
+            Map(static_cast<std::size_t>(st.st_size))) {
+            LoadSize();
+        }
+    }
+    if ((size_ == capacity_) && !Grow()) {
+        return false;
+    }
+
+    records_[size_] = record;
+    size_++;
+    static_cast<FileHeader*>(map_)->count = size_;
+    return true;
+}
+
+std::vector<GameRecord> ScoreStore::GetHighScores(
+    const ScoreKey& key, std::size_t num_scores) const {
+    auto is_better = [](const GameRecord& a, const GameRecord& b) {
+        return a.score > b.score;
+    };
+
+    /* keep the best scores seen so far sorted, later games only displace
+     * strictly lower scores */
+    std::vector<GameRecord> best;
+    best.reserve(num_scores + 1);
+    for (std::size_t i = 0; (i < size_) && (num_scores > 0); ++i) {
+        const GameRecord& record = records_[i];
+        if ((record.flags & kAutopilotFlag) || !key.Matches(record)) {
+            continue;
+        }
+        if ((best.size() == num_scores) && !is_better(record, best.back())) {
+            continue;
+        }
+        best.insert(std::upper_bound(best.begin(), best.end(), record,
+                                     is_better),
+                    record);
+        if (best.size() > num_scores) {
+            best.pop_back();
+        }
+    }
+    return best;
+}
+
+bool ScoreStore::GetBestScore(const ScoreKey& key, int& score) const {
+    for (; num_indexed_ < size_; ++num_indexed_) {
+        const GameRecord& record = records_[num_indexed_];
+        if (record.flags & kAutopilotFlag) {
+            continue;
+        }
+        const auto [it, inserted] = best_scores_.try_emplace(
+            std::make_tuple(static_cast<int>(record.mode),
+                            static_cast<int>(record.width),
+                            static_cast<int>(record.height)),
+            record.score);
+        if (!inserted) {
+            it->second = std::max(it->second, record.score);
+        }
+    }
+
+    const auto kBest =
+        best_scores_.find(std::make_tuple(key.mode, key.width, key.height));
+    if (best_scores_.end() == kBest) {
+        return false;
+    }
+    score = kBest->second;
+    return true;
+}
+
+ScoreSummary ScoreStore::Summarize(const ScoreKey& key) const {
+    ScoreSummary summary;
+    for (std::size_t i = 0; i < size_; ++i) {
+        const GameRecord& record = records_[i];
+        if (!key.Matches(record)) {
+            continue;
+        }
+        summary.games++;
+        summary.wins += (record.flags & kWonFlag) ? 1 : 0;
+        summary.total_score += record.score;
+        summary.total_ticks += record.ticks;
+        summary.total_duration_ms += record.duration_ms;
+        summary.high_score = std::max(summary.high_score, record.score);
+        summary.max_length = std::max(summary.max_length, record.length);
+    }
+    return summary;
+}
+
+std::vector<ScoreKey> ScoreStore::GetKeys() const {
+    std::set<std::tuple<int, int, int>> keys;
+    for (std::size_t i = 0; i < size_; ++i) {
+        keys.emplace(records_[i].mode, records_[i].width, records_[i].height);
+    }
+
+    std::vector<ScoreKey> ret;
+    ret.reserve(keys.size());
+    for (const auto& [mode, width, height] : keys) {
+        ret.push_back({.mode = mode, .width = width, .height = height});
+    }
+    return ret;
+}
+
+std::string GetDefaultScorePath() {
+    const char* home = std::getenv("HOME");
+    return (home && *home) ? (std::string(home) + "/.snake_scores") : "";
+}
+
+}  // namespace scores
+}  // namespace snake
@@ -0,0 +1,217 @@
+#include "sim/autopilot.hpp"
+
+#include <array>
+#include <utility>
+
+namespace snake {
+namespace sim {
+
+using snake::game::Direction;
+using snake::game::SnakeGame;
+using snake::game::Tile;
+
+/** Return the direction leading from one Tile to an adjacent Tile. */
+static Direction DirectionTo(const Tile& from, const Tile& to) {
+    if (to.row < from.row) {
+        return Direction::kUp;
+    }
+    if (to.row > from.row) {
+        return Direction::kDown;
+    }
+    return (to.col < from.col) ? Direction::kLeft : Direction::kRight;
+}
+
+void AutopilotController::NewGame(const SnakeGame& game, std::uint64_t seed) {
+    fallback_.NewGame(game, seed);
+    in_cycle_order_ = true;
+
+    /* the cycle only depends on the board so it can be kept between games */
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    if ((kDim.width != screen_dim_.width) ||
+        (kDim.height != screen_dim_.height) ||
+        (game.GetBorder() != border_)) {
+        BuildCycle(game);
+    }
+}
+
+void AutopilotController::AppendToCycle(int row, int col) {
+    const int kCell = row * screen_dim_.width + col;
+    cycle_index_[kCell] = NumCycleTiles();
+    cycle_.push_back(kCell);
+}
+
+void AutopilotController::BuildCycle(const SnakeGame& game) {
+    screen_dim_ = game.GetScreenDimension();
+    border_ = game.GetBorder();
+    cycle_.clear();
+    cycle_index_.assign(
+        static_cast<std::size_t>(screen_dim_.width * screen_dim_.height),
+        kNotOnCycle);
+    corner_ = kNotOnCycle;
+    corner_entry_ = kNotOnCycle;
+    corner_swap_ = kNotOnCycle;
+
+    const int kRows = screen_dim_.height - 2 * border_;
+    const int kCols = screen_dim_.width - 2 * border_;
+    if ((kRows < 2) || (kCols < 2)) {
+        return;
+    }
+
+    /* the cycle is laid out on a virtual grid with an even number of rows,
+     * which is the board itself or, if only the board's column count is
+     * even, the board transposed */
+    const bool kTranspose = (kRows % 2) && !(kCols % 2);
+    const int kVirtualRows = kTranspose ? kCols : kRows;
+    const int kVirtualCols = kTranspose ? kRows : kCols;
+    auto append = [&](int row, int col) {
+        if (kTranspose) {
+            std::swap(row, col);
+        }
+        AppendToCycle(border_ + row, border_ + col);
+    };
+
+    /* if both are odd, the last row is threaded into the row above it two
+     * Tiles at a time which leaves out its first Tile */
+    const bool kOdd = (kVirtualRows % 2);
+    const int kEvenRows = kOdd ? (kVirtualRows - 1) : kVirtualRows;
+
+    /* run along the first row, back and forth over the remaining rows
+     * leaving out the first column and back up the first column */
+    for (int col = 0; col < kVirtualCols; ++col) {
+        append(0, col);
+    }
+    for (int row = 1; row < kEvenRows; ++row) {
+        const bool kLeftward = (row % 2);
+        for (int i = 1; i < kVirtualCols; ++i) {
+            const int kCol = kLeftward ? (kVirtualCols - i) : i;
+            append(row, kCol);
+            if (kOdd && (kEvenRows - 1 == row) &&
+                !((kVirtualCols - 1 - kCol) % 2) && (kCol >= 2)) {
+                append(row + 1, kCol);
+                append(row + 1, kCol - 1);
+            }
+        }
+    }
+    for (int row = kEvenRows - 1; row > 0; --row) {
+        append(row, 0);
+    }
+
+    if (kOdd) {
+        const int kLastRow = border_ + kVirtualRows - 1;
+        corner_ = kLastRow * screen_dim_.width + border_;
+        corner_entry_ = corner_ + 1;
+        corner_swap_ = corner_entry_ - screen_dim_.width;
+    }
+}
+
+void AutopilotController::SwapCorner() {
+    /* the corner takes the place of its neighbour on the cycle, which is
+     * adjacent to the same two cycle Tiles */
+    const int kIndex = cycle_index_[corner_swap_];
+    cycle_[kIndex] = corner_;
+    cycle_index_[corner_] = kIndex;
+    cycle_index_[corner_swap_] = kNotOnCycle;
+    std::swap(corner_, corner_swap_);
+}
+
+bool AutopilotController::IsInCycleOrder(
+    const snake::game::Snake& snake) const {
+    /* walking from the tail to the head the distance along the cycle from
+     * the tail must keep growing */
+    const int kTail = CellIndex(snake.back());
+    if (kNotOnCycle == cycle_index_[kTail]) {
+        return false;
+    }
+    int prev_distance = 0;
+    for (std::size_t i = snake.size() - 1; i-- > 0;) {
+        const int kCell = CellIndex(snake[i]);
+        if (kNotOnCycle == cycle_index_[kCell]) {
+            return false;
+        }
+        const int kDistance = CycleDistance(kTail, kCell);
+        if (kDistance <= prev_distance) {
+            return false;
+        }
+        prev_distance = kDistance;
+    }
+    return true;
+}
+
+Direction AutopilotController::NextDirection(const SnakeGame& game) {
+    /* the cycle no longer fits the board once the game has been resized */
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    if ((kDim.width != screen_dim_.width) ||
+        (kDim.height != screen_dim_.height)) {
+        BuildCycle(game);
+        in_cycle_order_ = false;
+    }
+
+    const snake::game::Snake& snake = game.GetSnake();
+    if (!in_cycle_order_) {
+        in_cycle_order_ = !cycle_.empty() && IsInCycleOrder(snake);
+    }
+    if (cycle_.empty() || !in_cycle_order_) {
+        return fallback_.NextDirection(game);
+    }
+
+    const Tile& head = snake.front();
+    const int kHead = CellIndex(head);
+    const int kNumTiles = NumCycleTiles();
+
+    /* every Tile from the head up to the tail is free, all of them if the
+     * snake is a single Tile */
+    const int kTailDistance =
+        (1 == snake.size()) ? kNumTiles
+                            : CycleDistance(kHead, CellIndex(snake.back()));
+
+    int target_distance = 0;
+    const int kTarget = CellIndex(game.GetTargetTile());
+    if (kTarget == corner_) {
+        /* take the detour through the corner unless the neighbour it
+         * replaces on the cycle is taken, which at the detour's entry can
+         * only be the tail, or the snake is about to fill the board */
+        if (kHead == corner_entry_) {
+            const int kWidth = screen_dim_.width;
+            const Tile kSwap = {.row = corner_swap_ / kWidth,
+                                .col = corner_swap_ % kWidth};
+            if (static_cast<int>(snake.size()) == kNumTiles) {
+                return DirectionTo(head, game.GetTargetTile());
+            }
+            if (game.IsFree(kSwap)) {
+                SwapCorner();
+                return DirectionTo(head, game.GetTargetTile());
+            }
+        }
+        target_distance = CycleDistance(kHead, corner_entry_);
+    } else {
+        target_distance = CycleDistance(kHead, kTarget);
+    }
+
+    /* follow the cycle unless a neighbour further along it can be reached
+     * without passing the tail or the target */
+    const int kNext = cycle_[(cycle_index_[kHead] + 1) % kNumTiles];
+    Tile best = {.row = kNext / screen_dim_.width,
+                 .col = kNext % screen_dim_.width};
+    int best_distance = 1;
+    const std::array<Direction, 4> kDirections = {
+        Direction::kUp, Direction::kDown, Direction::kLeft, Direction::kRight};
+    for (const Direction& direction : kDirections) {
+        const Tile kNeighbor = Neighbor(head, direction);
+        if (!game.IsFree(kNeighbor) ||
+            (kNotOnCycle == cycle_index_[CellIndex(kNeighbor)])) {
+            continue;
+        }
+
+        const int kDistance = CycleDistance(kHead, CellIndex(kNeighbor));
+        if ((kDistance > best_distance) && (kDistance < kTailDistance) &&
+            (kDistance <= target_distance)) {
+            best = kNeighbor;
+            best_distance = kDistance;
+        }
+    }
+
+    return DirectionTo(head, best);
+}
+
+}  // namespace sim
+}  // namespace snake
@@ -0,0 +1,94 @@
+#include "sim/controller.hpp"
+
+#include <array>
+#include <cstdlib>
+
+#include "sim/autopilot.hpp"
+
+namespace snake {
+namespace sim {
+
+using snake::game::Direction;
+using snake::game::SnakeGame;
+using snake::game::Tile;
+
+static const std::array<Direction, 4> kDirections = {
+    Direction::kUp,
+    Direction::kDown,
+    Direction::kLeft,
+    Direction::kRight,
+};
+
+void RandomController::NewGame(const SnakeGame& game, std::uint64_t seed) {
+    (void)game;
+    rng_.Seed(seed);
+}
+
+Direction RandomController::NextDirection(const SnakeGame& game) {
+    /* pick one of the three directions that do not turn the snake around */
+    const Direction kReverse = Opposite(game.GetSnake().front().direction);
+    Direction direction = kReverse;
+    while (direction == kReverse) {
+        direction = kDirections[rng_.Below(kDirections.size())];
+    }
+    return direction;
+}
+
+Direction GreedyController::NextDirection(const SnakeGame& game) {
+    const Tile& head = game.GetSnake().front();
+    const Tile& target = game.GetTargetTile();
+
+    /* rank the directions by how much they close the distance to the target */
+    Direction best = head.direction;
+    int best_distance = 0;
+    bool found_safe = false;
+    for (const Direction& direction : kDirections) {
+        Tile next = Neighbor(head, direction);
+        if (!game.IsFree(next)) {
+            continue;
+        }
+
+        int distance =
+            std::abs(next.row - target.row) + std::abs(next.col - target.col);
+        if (!found_safe || (distance < best_distance)) {
+            best = direction;
+            best_distance = distance;
+            found_safe = true;
+        }
+    }
+
+    /* when boxed in keep going straight, the game is lost either way */
+    return best;
+}
+
+void PathController::NewGame(const SnakeGame& game, std::uint64_t seed) {
+    path_.Invalidate();
+    fallback_.NewGame(game, seed);
+}
+
+Direction PathController::NextDirection(const SnakeGame& game) {
+    Direction direction = Direction::kNone;
+    if (path_.NextDirection(game, direction)) {
+        return direction;
+    }
+    return fallback_.NextDirection(game);
+}
+
+std::unique_ptr<Controller> MakeController(const std::string& name) {
+    if ("random" == name) {
+        return std::make_unique<RandomController>();
+    }
+    if ("greedy" == name) {
+        return std::make_unique<GreedyController>();
+    }
+    if ("path" == name) {
+        return std::make_unique<PathController>();
+    }
+    if ("autopilot" == name) {
+        return std::make_unique<AutopilotController>();
+    }
+    return nullptr;
+}
+
+}  // namespace sim
+}  // namespace snake
@@ -0,0 +1,204 @@
+#include "sim/runner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace snake {
+namespace sim {
+
+void RunStats::Merge(const RunStats& other) {
+    games += other.games;
+    ticks += other.ticks;
+    wins += other.wins;
+    timeouts += other.timeouts;
+    elapsed_sec += other.elapsed_sec;
+    for (const auto& [score, count] : other.scores) {
+        scores[score] += count;
+    }
+    for (const auto& [length, count] : other.lengths) {
+        lengths[length] += count;
+    }
+}
+
+/** Play game number index of the run and record its outcome in stats. */
+static void PlayGame(const RunConfig& config, std::uint64_t index,
+                     snake::game::SnakeGame& game, Controller& controller,
+                     RunStats& stats) {
+    const std::uint64_t kGameSeed =
+        snake::game::SplitMix64(config.seed + index);
+    game.Reset(kGameSeed);
+    controller.NewGame(game, snake::game::SplitMix64(kGameSeed));
+
+    std::int64_t ticks = 0;
+    while (!game.GameOver() &&
+           (!config.max_ticks || (ticks < config.max_ticks))) {
+        game.Tick(controller.NextDirection(game));
+        ++ticks;
+    }
+
+    stats.games++;
+    stats.ticks += ticks;
+    if (!game.GameOver()) {
+        stats.timeouts++;
+    } else if (game.SnakeWins()) {
+        stats.wins++;
+    }
+    stats.scores[game.GetScore()]++;
+    stats.lengths[static_cast<int>(game.GetSnake().size())]++;
+}
+
+RunStats RunGames(const RunConfig& config, Controller& controller) {
+    RunStats stats;
+    std::pmr::monotonic_buffer_resource arena(
+        snake::game::SnakeGame::GetStorageSize(config.dim, 1));
+    snake::game::SnakeGame game(config.dim, 1, snake::game::Rng(config.seed),
+                                &arena);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::int64_t i = 0; i < config.num_games; ++i) {
+        PlayGame(config, static_cast<std::uint64_t>(i), game, controller,
+                 stats);
+    }
+    auto end = std::chrono::steady_clock::now();
+    stats.elapsed_sec = std::chrono::duration<double>(end - start).count();
+
+    return stats;
+}
+
+/**
+ * Range [begin, end) of game indices owned by one worker.
+ *
+ * Both bounds are packed into a single word so the owner taking games from the
+ * front and thieves taking games from the back agree through one CAS. Each
+ * range sits on its own cache line so workers do not contend on claims.
+ */
+class alignas(64) GameRange {
+   public:
+    void Assign(std::uint32_t begin, std::uint32_t end) {
+        range_.store(Pack(begin, end));
+    }
+
+    /** Claim up to max_games games from the front of the range. */
+    bool TakeFront(std::uint32_t max_games, std::uint32_t& begin,
+                   std::uint32_t& end) {
+        std::uint64_t range = range_.load();
+        do {
+            begin = Begin(range);
+            end = End(range);
+            if (begin == end) {
+                return false;
+            }
+            end = std::min(end, begin + max_games);
+        } while (!range_.compare_exchange_weak(range, Pack(end, End(range))));
+        return true;
+    }
+
+    /** Claim the back half (rounded up) of the range. */
+    bool StealBack(std::uint32_t& begin, std::uint32_t& end) {
+        std::uint64_t range = range_.load();
+        do {
+            begin = Begin(range);
+            end = End(range);
+            if (begin == end) {
+                return false;
+            }
+            begin += (end - begin) / 2;
+        } while (
+            !range_.compare_exchange_weak(range, Pack(Begin(range), begin)));
+        return true;
+    }
+
+   private:
+    static std::uint64_t Pack(std::uint32_t begin, std::uint32_t end) {
+        return (static_cast<std::uint64_t>(begin) << 32) | end;
+    }
+    static std::uint32_t Begin(std::uint64_t range) {
+        return static_cast<std::uint32_t>(range >> 32);
+    }
+    static std::uint32_t End(std::uint64_t range) {
+        return static_cast<std::uint32_t>(range);
+    }
+
+    std::atomic<std::uint64_t> range_{0};
+};
+
+RunStats RunGamesParallel(const RunConfig& config,
+                          const ControllerFactory& make_controller) {
+    const auto kNumThreads =
+        static_cast<std::uint32_t>(std::max(1, config.num_threads));
+    const auto kNumGames = static_cast<std::uint32_t>(config.num_games);
+
+    /* hand every worker an equal share of the games to start with */
+    std::vector<GameRange> ranges(kNumThreads);
+    for (std::uint32_t i = 0; i < kNumThreads; ++i) {
+        ranges[i].Assign(static_cast<std::uint32_t>(
+                             std::uint64_t{kNumGames} * i / kNumThreads),
+                         static_cast<std::uint32_t>(
+                             std::uint64_t{kNumGames} * (i + 1) / kNumThreads));
+    }
+
+    std::vector<RunStats> worker_stats(kNumThreads);
+    auto work = [&](std::uint32_t id) {
+        /* claim games a few at a time to keep traffic on the range low */
+        const std::uint32_t kChunkSize = 16;
+
+        /* all of the worker's game lives in a single block allocated, and
+         * so first touched, by the worker's own thread */
+        std::pmr::monotonic_buffer_resource arena(
+            snake::game::SnakeGame::GetStorageSize(config.dim, 1));
+        snake::game::SnakeGame game(config.dim, 1,
+                                    snake::game::Rng(config.seed), &arena);
+        std::unique_ptr<Controller> controller = make_controller();
+        RunStats stats;
+
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+        while (true) {
+            if (ranges[id].TakeFront(kChunkSize, begin, end)) {
+                for (std::uint32_t i = begin; i < end; ++i) {
+                    PlayGame(config, i, game, *controller, stats);
+                }
+                continue;
+            }
+
+            /* out of work, steal from the next worker that still has some */
+            bool stolen = false;
+            for (std::uint32_t j = 1; !stolen && (j < kNumThreads); ++j) {
+                stolen = ranges[(id + j) % kNumThreads].StealBack(begin, end);
+            }
+            if (!stolen) {
+                break; /* every remaining game has already been claimed */
+            }
+            ranges[id].Assign(begin, end);
+        }
+        worker_stats[id] = std::move(stats);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::uint32_t i = 1; i < kNumThreads; ++i) {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    RunStats stats;
+    for (const RunStats& worker : worker_stats) {
+        stats.Merge(worker);
+    }
+    stats.elapsed_sec = std::chrono::duration<double>(end - start).count();
+
+    return stats;
+}
+
+}  // namespace sim
+}  // namespace snake
@@ -1,54 +1,480 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "game/game.hpp"
+#include "game/input_queue.hpp"
+#include "graphics/render_thread.hpp"
 #include "graphics/screen.hpp"
+#include "metrics/metrics.hpp"
+#include "net/server.hpp"
+#include "replay/replay.hpp"
+#include "scores/score_store.hpp"
+#include "sim/autopilot.hpp"
 
-void RunGameLoop(snake::game::SnakeGame& game,
-                 const snake::graphics::GameMode& mode) {
-    /* adjust the input delay in order tick the game faster or slower */
-    const int kEasyModeDelayMs = 150;
-    const int kMedModeDelayMs = 100;
-    const int kHardModeDelayMs = 75;
+using Clock = std::chrono::steady_clock;
+
+/** Running count, mean, deviation and extremes of a series of samples. */
+struct SampleStats {
+    std::int64_t count = 0;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double max = 0.0;
+
+    void Add(double sample) {
+        count++;
+        sum += sample;
+        sum_sq += sample * sample;
+        max = (1 == count) ? sample : std::max(max, sample);
+    }
+    double Mean() const { return count ? (sum / count) : 0.0; }
+    double StdDev() const {
+        double variance = count ? (sum_sq / count - Mean() * Mean()) : 0.0;
+        return std::sqrt(std::max(0.0, variance));
+    }
+};
+
+struct LoopStats {
+    SampleStats frame_bytes;  /**< Bytes written to the terminal per frame. */
+    SampleStats frame_us;     /**< Time spent drawing a frame. */
+    SampleStats tick_late_us; /**< How late each tick ran past its schedule. */
+    std::int64_t skipped_ticks = 0; /**< Ticks dropped after a long stall. */
+};
+
+static void DrawScreen(const snake::game::SnakeGame& game, bool paused) {
+    SNAKE_METRICS_TIME(Metric::kRenderLatency);
+    if (!paused) {
+        snake::graphics::DrawSnakeScreen(game);
+        return;
+    }
+
+    const snake::game::ScreenDimension kMinDim = game.GetMinScreenDimension();
+    snake::graphics::DrawMessageScreen(
+        "terminal too small, enlarge it to " + std::to_string(kMinDim.width) +
+        " columns by " + std::to_string(kMinDim.height) + " rows");
+}
+
+static void Tick(snake::game::SnakeGame& game,
+                 const snake::game::Direction& direction) {
+    {
+        SNAKE_METRICS_TIME(Metric::kTickLatency);
+        game.Tick(direction);
+    }
+    SNAKE_METRICS_RECORD(Metric::kSnakeLength, game.GetSnake().size());
+}
+
+/**
+ * Draw a frame and, if stats is not null, record its cost. Called on the
+ * render thread.
+ */
+static void DrawFrame(const snake::game::SnakeGame& game, bool paused,
+                      LoopStats* stats) {
+    if (!stats) {
+        DrawScreen(game, paused);
+        SNAKE_METRICS_END_FRAME();
+        return;
+    }
+
+    std::uint64_t bytes_before = snake::graphics::GetBytesWritten();
+    Clock::time_point start = Clock::now();
+    DrawScreen(game, paused);
+    Clock::time_point end = Clock::now();
+    std::uint64_t bytes = snake::graphics::GetBytesWritten() - bytes_before;
+
+    stats->frame_bytes.Add(static_cast<double>(bytes));
+    stats->frame_us.Add(
+        std::chrono::duration<double, std::micro>(end - start).count());
+    SNAKE_METRICS_END_FRAME();
+}
+
+static void PrintSampleStats(const char* name, const SampleStats& stats) {
+    std::printf("%-16s count %lld  mean %.1f  stddev %.1f  max %.1f\n", name,
+                static_cast<long long>(stats.count), stats.Mean(),
+                stats.StdDev(), stats.max);
+}
+
+static void PrintLoopStats(const LoopStats& stats) {
+    PrintSampleStats("frame bytes:", stats.frame_bytes);
+    PrintSampleStats("frame time (us):", stats.frame_us);
+    PrintSampleStats("tick late (us):", stats.tick_late_us);
+    std::printf("%-16s %lld\n", "skipped ticks:",
+                static_cast<long long>(stats.skipped_ticks));
+}
+
+/**
+ * Append a summary of the finished game to the score store.
+ *
+ * @returns The best score of a game played by hand in the same mode on a
+ *          board of the same size, this one included, or kNoHighScore if
+ *          there is none.
+ */
+static int RecordGame(snake::scores::ScoreStore& store,
+                      const snake::game::SnakeGame& game,
+                      const snake::graphics::GameMode& mode,
+                      Clock::duration duration, bool autopilot) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    snake::scores::GameRecord record;
+    record.end_time_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    record.duration_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count();
+    record.ticks = game.GetTicks();
+    record.score = game.GetScore();
+    record.length = static_cast<std::uint32_t>(game.GetSnake().size());
+    record.width = static_cast<std::uint16_t>(kDim.width);
+    record.height = static_cast<std::uint16_t>(kDim.height);
+    record.mode = static_cast<std::uint8_t>(mode);
+    record.flags = (game.SnakeWins() ? snake::scores::kWonFlag : 0) |
+                   (autopilot ? snake::scores::kAutopilotFlag : 0);
+    (void)store.Append(record);
+
+    int best_score = snake::graphics::kNoHighScore;
+    (void)store.GetBestScore(
+        {.mode = record.mode, .width = kDim.width, .height = kDim.height},
+        best_score);
+    return best_score;
+}
+
+static void PrintHelp() {
+    std::printf(
+        "Snake for the Terminal\n"
+        "\n"
+        "usage: snake [OPTION]...\n"
+        "options:\n"
+        "\t-a       let the autopilot play the game\n"
+        "\t-r FILE  record the game to a replay file\n"
+        "\t-s       print frame and tick timing statistics on exit\n"
+        "\t-g NAME  renderer: curses, ansi or null (default curses)\n"
+        "\t-m FILE  write metric histograms to FILE on exit, CSV if FILE\n"
+        "\t         ends in .csv and JSON otherwise\n"
+        "\t-u PATH  stream metric samples to the Unix socket at PATH\n"
+        "\t-l ADDR  let spectators watch the game at ADDR, a TCP port on\n"
+        "\t         the local host or the path of a Unix socket\n"
+        "\t-k FILE  keep high scores and game summaries in FILE\n"
+        "\t         (default ~/.snake_scores)\n"
+        "\t-h       print this help message\n"
+        "\n"
+        "-m and -u require a build with SNAKE_METRICS enabled.\n");
+}
+
+static Clock::duration TickPeriod(const snake::graphics::GameMode& mode) {
+    /* adjust the tick period in order tick the game faster or slower */
+    const std::chrono::milliseconds kEasyModePeriod(150);
+    const std::chrono::milliseconds kMedModePeriod(100);
+    const std::chrono::milliseconds kHardModePeriod(75);
     switch (mode) {
         case snake::graphics::GameMode::kEasy:
-            snake::graphics::EnableInputDelay(kEasyModeDelayMs);
-            break;
+            return kEasyModePeriod;
         case snake::graphics::GameMode::kMedium:
-            snake::graphics::EnableInputDelay(kMedModeDelayMs);
-            break;
+            return kMedModePeriod;
         case snake::graphics::GameMode::kHard:
-            snake::graphics::EnableInputDelay(kHardModeDelayMs);
-            break;
+            return kHardModePeriod;
+    }
+    return kEasyModePeriod;
+}
+
+/**
+ * Move the game onto a resized screen.
+ *
+ * The resize is recorded to the replay and the spectators are sent a
+ * snapshot, each if not null.
+ *
+ * @returns false if the screen is too small for the game.
+ */
+static bool ResizeGame(snake::game::SnakeGame& game,
+                       const snake::game::ScreenDimension& dim,
+                       snake::replay::Replay* replay,
+                       snake::net::SpectatorServer* server) {
+    const snake::game::ScreenDimension kPrevDim = game.GetScreenDimension();
+    if (!game.Resize(dim)) {
+        return false;
     }
+    if ((dim.width == kPrevDim.width) && (dim.height == kPrevDim.height)) {
+        return true;
+    }
+    if (replay) {
+        replay->AppendResize(dim);
+    }
+    if (server) {
+        server->BroadcastSnapshot(game);
+    }
+    return true;
+}
+
+/**
+ * Tick the game on a fixed schedule until it ends.
+ *
+ * The screen is drawn and the keypad read on a RenderThread, so the ticks
+ * never wait on the terminal. Key presses are queued as they arrive and never
+ * advance the game early. Each tick consumes at most one queued turn so quick
+ * turns made within a single tick period play out over consecutive ticks
+ * instead of collapsing into the last one, and reversals are dropped before
+ * they reach the game. A frame is published once the ticks that were due have
+ * run. If replay is not null, the direction of every tick is appended to it.
+ * If autopilot is not null, it steers the snake and key presses are ignored.
+ * If server is not null, every tick is queued for its spectators and sent
+ * along with the frame. Terminal resizes are handled at the next tick,
+ * however many arrived. The game is paused while the terminal is too small
+ * for it.
+ */
+void RunGameLoop(snake::game::SnakeGame& game,
+                 const snake::graphics::GameMode& mode, LoopStats* stats,
+                 snake::replay::Replay* replay,
+                 snake::sim::Controller* autopilot,
+                 snake::net::SpectatorServer* server) {
+    const Clock::duration kPeriod = TickPeriod(mode);
+
+    /* after a long stall (e.g., the process was suspended) resume the regular
+     * cadence instead of running every missed tick back to back */
+    const int kMaxCatchUpTicks = 3;
 
     snake::game::Direction curr_direction = game.GetSnake().front().direction;
+    snake::game::InputQueue input(curr_direction);
+    snake::graphics::RenderThread render_thread(
+        game, input,
+        [stats](const snake::game::SnakeGame& frame_game, bool paused) {
+            DrawFrame(frame_game, paused, stats);
+        });
+    render_thread.Publish(game);
+
+    Clock::time_point next_tick = Clock::now() + kPeriod;
+    bool paused = false;
     while (!game.GameOver()) {
-        snake::game::Direction new_direction = snake::graphics::ReadKeypad();
+        /* key presses are queued by the render thread in the meantime */
+        std::this_thread::sleep_until(next_tick);
+        Clock::time_point now = Clock::now();
 
-        /* update the direction only if the user provided one */
-        if (new_direction != snake::game::Direction::kNone) {
-            curr_direction = new_direction;
+        /* move the game onto the terminal's latest dimensions, pausing it
+         * while they are too small */
+        snake::game::ScreenDimension dim = game.GetScreenDimension();
+        if (render_thread.TakeResize(dim)) {
+            paused = !ResizeGame(game, dim, replay, server);
+            render_thread.Publish(game, paused);
+            next_tick = now + kPeriod;
+            continue;
+        }
+        if (paused) {
+            next_tick = now + kPeriod;
+            continue;
+        }
+
+        int num_ticks = 0;
+        while ((now >= next_tick) && !game.GameOver()) {
+            if (kMaxCatchUpTicks == num_ticks) {
+                auto missed = (now - next_tick) / kPeriod + 1;
+                if (stats) {
+                    stats->skipped_ticks += missed;
+                }
+                next_tick += missed * kPeriod;
+                break;
+            }
+
+            if (autopilot) {
+                curr_direction = autopilot->NextDirection(game);
+            } else {
+                input.Pop(curr_direction);
+            }
+            if (stats) {
+                stats->tick_late_us.Add(
+                    std::chrono::duration<double, std::micro>(Clock::now() -
+                                                              next_tick)
+                        .count());
+            }
+            Tick(game, curr_direction);
+            if (replay) {
+                replay->Append(curr_direction);
+            }
+            if (server) {
+                server->Broadcast(game);
+            }
+
+            next_tick += kPeriod;
+            num_ticks++;
+        }
+
+        render_thread.Publish(game);
+        if (server) {
+            server->Update(game);
         }
-        game.Tick(curr_direction);
-        snake::graphics::DrawSnakeScreen(game);
     }
+    render_thread.Stop();
     snake::graphics::DisableInputDelay();
 }
 
-int main() {
+int main(int argc, char** argv) {
+    bool print_stats = false;
+    const char* replay_path = nullptr;
+    bool use_autopilot = false;
+    const char* metrics_path = nullptr;
+    const char* metrics_socket = nullptr;
+    const char* spectator_address = nullptr;
+    const char* score_path = nullptr;
+    std::string renderer_name("curses");
+
+    int flag = 0;
+    while ((flag = getopt(argc, argv, ":ar:sg:m:u:l:k:h")) != -1) {
+        switch (flag) {
+            case 'a':
+                use_autopilot = true;
+                break;
+            case 'r':
+                replay_path = optarg;
+                break;
+            case 's':
+                print_stats = true;
+                break;
+            case 'g':
+                renderer_name = optarg;
+                break;
+            case 'm':
+                metrics_path = optarg;
+                break;
+            case 'u':
+                metrics_socket = optarg;
+                break;
+            case 'l':
+                spectator_address = optarg;
+                break;
+            case 'k':
+                score_path = optarg;
+                break;
+            case 'h':
+                PrintHelp();
+                return 0;
+            default:
+                std::fprintf(stderr, "error: invalid option '%c'\n", optopt);
+                PrintHelp();
+                return 1;
+        }
+    }
+    if ((metrics_path || metrics_socket) && !snake::metrics::kEnabled) {
+        std::fprintf(stderr, "error: built without SNAKE_METRICS\n");
+        return 1;
+    }
+    snake::metrics::Recorder& recorder = snake::metrics::GlobalRecorder();
+    if (metrics_socket && !recorder.ConnectSocket(metrics_socket)) {
+        std::fprintf(stderr, "error: unable to connect to socket '%s'\n",
+                     metrics_socket);
+        return 1;
+    }
+
+    /* a null renderer selects the default ncurses renderer */
+    snake::graphics::AnsiRenderer ansi_renderer;
+    snake::graphics::NullRenderer null_renderer;
+    snake::graphics::Renderer* renderer = nullptr;
+    if ("ansi" == renderer_name) {
+        renderer = &ansi_renderer;
+    } else if ("null" == renderer_name) {
+        renderer = &null_renderer;
+    } else if ("curses" != renderer_name) {
+        std::fprintf(stderr, "error: unknown renderer '%s'\n",
+                     renderer_name.c_str());
+        return 1;
+    }
+
+    snake::net::SpectatorServer server;
+    if (spectator_address && !server.Listen(spectator_address)) {
+        std::fprintf(stderr, "error: unable to listen at '%s'\n",
+                     spectator_address);
+        return 1;
+    }
+    snake::net::SpectatorServer* spectators =
+        spectator_address ? &server : nullptr;
+
+    /* a missing default score file is created, failing that the game is
+     * still played without keeping its score */
+    const std::string kScorePath =
+        score_path ? score_path : snake::scores::GetDefaultScorePath();
+    snake::scores::ScoreStore scores;
+    if (!kScorePath.empty() && !scores.Open(kScorePath) && score_path) {
+        std::fprintf(stderr, "error: unable to open score file '%s'\n",
+                     score_path);
+        return 1;
+    }
+
+    LoopStats stats;
+    LoopStats* loop_stats = print_stats ? &stats : nullptr;
+
     /* configure the screen */
     snake::game::ScreenDimension screen_dim = snake::graphics::InitScreen();
 
     /* display the start menu and fetch the user's game mode selection */
     snake::graphics::GameMode mode = snake::graphics::PromptForGameMode();
+    snake::graphics::SetRenderer(renderer);
+
+    /* index the best scores before the game starts, recording the game then
+     * only reads the records appended since */
+    int best_score = snake::graphics::kNoHighScore;
+    (void)scores.GetBestScore({.mode = static_cast<int>(mode),
+                               .width = screen_dim.width,
+                               .height = screen_dim.height},
+                              best_score);
+
+    /* seed the game explicitly so that it can be replayed */
+    snake::replay::Replay replay;
+    replay.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) |
+                  std::random_device{}();
+    replay.dim = screen_dim;
+    snake::replay::Replay* game_replay = replay_path ? &replay : nullptr;
+
+    snake::game::SnakeGame game(screen_dim, replay.border,
+                                snake::game::Rng(replay.seed));
 
-    /* draw the initial game screen */
-    snake::game::SnakeGame game(screen_dim);
-    snake::graphics::DrawSnakeScreen(game);
+    snake::sim::AutopilotController autopilot;
+    autopilot.NewGame(game, replay.seed);
 
-    RunGameLoop(game, mode);
+    Clock::time_point start = Clock::now();
+    RunGameLoop(game, mode, loop_stats, game_replay,
+                use_autopilot ? &autopilot : nullptr, spectators);
+    int high_score = snake::graphics::kNoHighScore;
+    if (scores.IsOpen()) {
+        high_score = RecordGame(scores, game, mode, Clock::now() - start,
+                                use_autopilot);
+    }
 
     /* show the game over screen with the score and exit */
-    snake::graphics::DrawGameOverScreen(game);
+    snake::graphics::DrawGameOverScreen(game, high_score);
     snake::graphics::TerminateScreen();
 
+    if (print_stats) {
+        PrintLoopStats(stats);
+    }
+
+    if (replay_path) {
+        std::ofstream file(replay_path, std::ios::binary);
+        if (!file || !snake::replay::WriteReplay(file, replay)) {
+            std::fprintf(stderr, "error: unable to write replay '%s'\n",
+                         replay_path);
+            return 1;
+        }
+    }
+
+    if (metrics_path) {
+        const std::string kPath(metrics_path);
+        const std::string kCsv(".csv");
+        const bool kIsCsv =
+            (kPath.size() >= kCsv.size()) &&
+            (0 == kPath.compare(kPath.size() - kCsv.size(), kCsv.size(), kCsv));
+        std::ofstream file(metrics_path);
+        if (!file || !(kIsCsv ? recorder.WriteCsv(file)
+                              : recorder.WriteJson(file))) {
+            std::fprintf(stderr, "error: unable to write metrics '%s'\n",
+                         metrics_path);
+            return 1;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,138 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "game/game.hpp"
+#include "replay/player.hpp"
+#include "replay/replay.hpp"
+
+static void PrintHelp() {
+    std::printf(
+        "Rebuild the game state at any tick of a recorded Snake game\n"
+        "\n"
+        "usage: snake_replay [OPTION]... FILE\n"
+        "options:\n"
+        "\t-t NUM    tick to seek to, may be repeated (default last tick)\n"
+        "\t-k NUM    initial ticks between checkpoints (default %lld)\n"
+        "\t-p        print the board after each seek\n"
+        "\t-h        print this help message\n",
+        static_cast<long long>(
+            snake::replay::ReplayPlayer::kDefaultCheckpointInterval));
+}
+
+static void PrintBoard(const snake::game::SnakeGame& game) {
+    const snake::game::ScreenDimension kDim = game.GetScreenDimension();
+    std::vector<std::string> rows(static_cast<std::size_t>(kDim.height),
+                                  std::string(kDim.width, '#'));
+    for (int i = game.GetBorder(); i < (kDim.height - game.GetBorder()); ++i) {
+        for (int j = game.GetBorder(); j < (kDim.width - game.GetBorder());
+             ++j) {
+            rows[i][j] = ' ';
+        }
+    }
+
+    /* draw the head last, it may lie on top of the body if the game is over */
+    const snake::game::Tile& kTarget = game.GetTargetTile();
+    rows[kTarget.row][kTarget.col] = '*';
+    for (const snake::game::Tile& tile : game.GetSnake()) {
+        if (game.IsInBounds(tile)) {
+            rows[tile.row][tile.col] = 'o';
+        }
+    }
+    const snake::game::Tile& kHead = game.GetSnake().front();
+    if ((kHead.row >= 0) && (kHead.row < kDim.height) && (kHead.col >= 0) &&
+        (kHead.col < kDim.width)) {
+        rows[kHead.row][kHead.col] = '@';
+    }
+
+    for (const std::string& row : rows) {
+        std::printf("%s\n", row.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::int64_t> seeks;
+    std::int64_t checkpoint_interval =
+        snake::replay::ReplayPlayer::kDefaultCheckpointInterval;
+    bool print_board = false;
+
+    int flag = 0;
+    while ((flag = getopt(argc, argv, ":t:k:ph")) != -1) {
+        switch (flag) {
+            case 't':
+                seeks.push_back(std::atoll(optarg));
+                break;
+            case 'k':
+                checkpoint_interval = std::atoll(optarg);
+                break;
+            case 'p':
+                print_board = true;
+                break;
+            case 'h':
+                PrintHelp();
+                return 0;
+            default:
+                std::fprintf(stderr, "error: invalid option '%c'\n", optopt);
+                PrintHelp();
+                return 1;
+        }
+    }
+    if ((argc - optind) != 1) {
+        std::fprintf(stderr, "error: expected a single replay file\n");
+        PrintHelp();
+        return 1;
+    }
+
+    std::ifstream file(argv[optind], std::ios::binary);
+    snake::replay::Replay replay;
+    if (!file || !snake::replay::ReadReplay(file, replay)) {
+        std::fprintf(stderr, "error: unable to read replay '%s'\n",
+                     argv[optind]);
+        return 1;
+    }
+
+    snake::replay::ReplayPlayer player(replay, checkpoint_interval);
+    if (seeks.empty()) {
+        seeks.push_back(player.NumTicks());
+    }
+
+    std::printf("board:        %dx%d\n", replay.dim.width, replay.dim.height);
+    std::printf("seed:         %llu\n",
+                static_cast<unsigned long long>(replay.seed));
+    std::printf("ticks:        %lld\n",
+                static_cast<long long>(player.NumTicks()));
+    std::printf("runs:         %zu\n", replay.runs.size());
+    std::printf("resizes:      %zu\n", replay.resizes.size());
+
+    for (std::int64_t tick : seeks) {
+        const std::int64_t kFrom = player.GetTick();
+        auto start = std::chrono::steady_clock::now();
+        player.Seek(tick);
+        auto end = std::chrono::steady_clock::now();
+        const double kElapsedSec =
+            std::chrono::duration<double>(end - start).count();
+
+        const snake::game::SnakeGame& kGame = player.GetGame();
+        const snake::game::Tile& kHead = kGame.GetSnake().front();
+        const snake::game::Tile& kTarget = kGame.GetTargetTile();
+        std::printf(
+            "\ntick %lld (from %lld, %zu checkpoints, %.3f ms)\n"
+            "  score %d  length %zu  head (%d, %d)  target (%d, %d)%s\n",
+            static_cast<long long>(player.GetTick()),
+            static_cast<long long>(kFrom), player.NumCheckpoints(),
+            kElapsedSec * 1e3, kGame.GetScore(), kGame.GetSnake().size(),
+            kHead.row, kHead.col, kTarget.row, kTarget.col,
+            kGame.GameOver() ? "  game over" : "");
+        if (print_board) {
+            PrintBoard(kGame);
+        }
+    }
+
+    return 0;
+}
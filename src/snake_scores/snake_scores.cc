@@ -0,0 +1,115 @@
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "graphics/screen.hpp"
+#include "scores/score_store.hpp"
+
+static void PrintHelp() {
+    std::printf(
+        "Show the high scores and statistics of past Snake games\n"
+        "\n"
+        "usage: snake_scores [OPTION]...\n"
+        "options:\n"
+        "\t-f FILE  score file to read (default ~/.snake_scores)\n"
+        "\t-n NUM   high scores to list per mode and board (default 10)\n"
+        "\t-h       print this help message\n");
+}
+
+static const char* GetModeName(int mode) {
+    switch (static_cast<snake::graphics::GameMode>(mode)) {
+        case snake::graphics::GameMode::kEasy:
+            return "easy";
+        case snake::graphics::GameMode::kMedium:
+            return "medium";
+        case snake::graphics::GameMode::kHard:
+            return "hard";
+    }
+    return "unknown";
+}
+
+/** Return the parameter Unix time in ms as local date and time. */
+static std::string FormatTime(std::int64_t time_ms) {
+    const std::time_t kTime = static_cast<std::time_t>(time_ms / 1000);
+    std::tm local = {};
+    char buffer[32] = {};
+    if (!localtime_r(&kTime, &local) ||
+        !std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", &local)) {
+        return "?";
+    }
+    return buffer;
+}
+
+static void PrintSummary(const char* name,
+                         const snake::scores::ScoreSummary& summary) {
+    const double kMeanScore =
+        summary.games ? (static_cast<double>(summary.total_score) /
+                         static_cast<double>(summary.games))
+                      : 0.0;
+    std::printf(
+        "%s: %lld games, %lld won, high score %d, mean score %.1f, longest "
+        "snake %u, %lld ticks, %.1f minutes played\n",
+        name, static_cast<long long>(summary.games),
+        static_cast<long long>(summary.wins), summary.high_score, kMeanScore,
+        summary.max_length, static_cast<long long>(summary.total_ticks),
+        static_cast<double>(summary.total_duration_ms) / 60000.0);
+}
+
+int main(int argc, char** argv) {
+    std::string path = snake::scores::GetDefaultScorePath();
+    std::size_t num_scores = 10;
+
+    int flag = 0;
+    while ((flag = getopt(argc, argv, ":f:n:h")) != -1) {
+        switch (flag) {
+            case 'f':
+                path = optarg;
+                break;
+            case 'n':
+                num_scores = static_cast<std::size_t>(std::atoll(optarg));
+                break;
+            case 'h':
+                PrintHelp();
+                return 0;
+            default:
+                std::fprintf(stderr, "error: invalid option '%c'\n", optopt);
+                PrintHelp();
+                return 1;
+        }
+    }
+
+    /* opening creates a missing file, which then lists no games */
+    snake::scores::ScoreStore store;
+    if (path.empty() || !store.Open(path)) {
+        std::fprintf(stderr, "error: unable to open score file '%s'\n",
+                     path.c_str());
+        return 1;
+    }
+
+    PrintSummary("all games", store.Summarize({}));
+    for (const snake::scores::ScoreKey& key : store.GetKeys()) {
+        const std::string kName = std::string(GetModeName(key.mode)) + " " +
+                                  std::to_string(key.width) + "x" +
+                                  std::to_string(key.height);
+        std::printf("\n");
+        PrintSummary(kName.c_str(), store.Summarize(key));
+
+        const std::vector<snake::scores::GameRecord> kBest =
+            store.GetHighScores(key, num_scores);
+        for (std::size_t i = 0; i < kBest.size(); ++i) {
+            std::printf("  %3zu. %6d  length %-5u %6lld ticks  %s%s\n", i + 1,
+                        kBest[i].score, kBest[i].length,
+                        static_cast<long long>(kBest[i].ticks),
+                        FormatTime(kBest[i].end_time_ms).c_str(),
+                        (kBest[i].flags & snake::scores::kWonFlag) ? "  won"
+                                                                   : "");
+        }
+    }
+
+    return 0;
+}
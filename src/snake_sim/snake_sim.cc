@@ -0,0 +1,179 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "game/game.hpp"
+#include "sim/controller.hpp"
+#include "sim/runner.hpp"
+
+static void PrintHelp() {
+    std::printf(
+        "Run Snake games without a terminal and report engine throughput\n"
+        "\n"
+        "usage: snake_sim [OPTION]...\n"
+        "options:\n"
+        "\t-c NAME   controller policy: random, greedy, path, autopilot\n"
+        "\t          (default greedy)\n"
+        "\t-n NUM    number of games to play (default 100000)\n"
+        "\t-x NUM    board width including the border (default 80)\n"
+        "\t-y NUM    board height including the border (default 24)\n"
+        "\t-t NUM    per game tick limit, 0 for none (default 10 x board)\n"
+        "\t-b NUM    number of length histogram buckets (default 10)\n"
+        "\t-s NUM    base seed of the run (default random)\n"
+        "\t-j NUM    number of worker threads (default all cores)\n"
+        "\t-h        print this help message\n");
+}
+
+/** Return the smallest key whose cumulative count covers the fraction q. */
+static int Percentile(const std::map<int, std::int64_t>& counts,
+                      std::int64_t total, double q) {
+    const auto kRank =
+        static_cast<std::int64_t>(q * static_cast<double>(total));
+    std::int64_t seen = 0;
+    for (const auto& [key, count] : counts) {
+        seen += count;
+        if (seen > kRank) {
+            return key;
+        }
+    }
+    return counts.empty() ? 0 : counts.rbegin()->first;
+}
+
+static void PrintScores(const snake::sim::RunStats& stats) {
+    double sum = 0.0;
+    for (const auto& [score, count] : stats.scores) {
+        sum += static_cast<double>(score) * static_cast<double>(count);
+    }
+
+    std::printf("score:\n");
+    std::printf("  min   %d\n", stats.scores.begin()->first);
+    std::printf("  mean  %.2f\n", sum / static_cast<double>(stats.games));
+    std::printf("  p50   %d\n", Percentile(stats.scores, stats.games, 0.50));
+    std::printf("  p90   %d\n", Percentile(stats.scores, stats.games, 0.90));
+    std::printf("  p99   %d\n", Percentile(stats.scores, stats.games, 0.99));
+    std::printf("  max   %d\n", stats.scores.rbegin()->first);
+}
+
+static void PrintLengths(const snake::sim::RunStats& stats, int num_buckets) {
+    /* split the observed length range into equal width buckets */
+    const int kMinLength = stats.lengths.begin()->first;
+    const int kMaxLength = stats.lengths.rbegin()->first;
+    const int kWidth =
+        std::max(1, (kMaxLength - kMinLength + num_buckets) / num_buckets);
+
+    std::map<int, std::int64_t> buckets;
+    std::int64_t max_count = 0;
+    for (const auto& [length, count] : stats.lengths) {
+        std::int64_t& bucket = buckets[(length - kMinLength) / kWidth];
+        bucket += count;
+        max_count = std::max(max_count, bucket);
+    }
+
+    const int kBarWidth = 40;
+    std::printf("length at game end:\n");
+    for (const auto& [bucket, count] : buckets) {
+        const int kLow = kMinLength + bucket * kWidth;
+        const auto kBar = static_cast<int>(count * kBarWidth / max_count);
+        std::printf("  [%6d, %6d) %10lld %s\n", kLow, kLow + kWidth,
+                    static_cast<long long>(count),
+                    std::string(static_cast<std::size_t>(kBar), '#').c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string controller_name("greedy");
+    snake::sim::RunConfig config;
+    config.dim = {.width = 80, .height = 24};
+    config.num_games = 100000;
+    config.max_ticks = -1;
+    config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) |
+                  std::random_device{}();
+    config.num_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int num_buckets = 10;
+
+    int flag = 0;
+    while ((flag = getopt(argc, argv, ":c:n:x:y:t:b:s:j:h")) != -1) {
+        switch (flag) {
+            case 'c':
+                controller_name = optarg;
+                break;
+            case 'n':
+                config.num_games = std::atoll(optarg);
+                break;
+            case 'x':
+                config.dim.width = std::atoi(optarg);
+                break;
+            case 'y':
+                config.dim.height = std::atoi(optarg);
+                break;
+            case 't':
+                config.max_ticks = std::atoll(optarg);
+                break;
+            case 'b':
+                num_buckets = std::max(1, std::atoi(optarg));
+                break;
+            case 's':
+                config.seed = std::strtoull(optarg, nullptr, 0);
+                break;
+            case 'j':
+                config.num_threads = std::max(1, std::atoi(optarg));
+                break;
+            case 'h':
+                PrintHelp();
+                return 0;
+            default:
+                std::fprintf(stderr, "error: invalid option '%c'\n", optopt);
+                PrintHelp();
+                return 1;
+        }
+    }
+
+    const int kMinDim = 3; /* at least one playable tile inside the border */
+    if ((config.dim.width < kMinDim) || (config.dim.height < kMinDim) ||
+        (config.dim.width > snake::game::kMaxPackedCoordinate) ||
+        (config.dim.height > snake::game::kMaxPackedCoordinate) ||
+        (config.num_games < 1) || (config.num_games > UINT32_MAX)) {
+        std::fprintf(stderr, "error: invalid board size or game count\n");
+        return 1;
+    }
+    if (config.max_ticks < 0) {
+        const std::int64_t kTicksPerTile = 10;
+        config.max_ticks = kTicksPerTile * config.dim.width * config.dim.height;
+    }
+
+    if (!snake::sim::MakeController(controller_name)) {
+        std::fprintf(stderr, "error: unknown controller '%s'\n",
+                     controller_name.c_str());
+        return 1;
+    }
+
+    snake::sim::RunStats stats = snake::sim::RunGamesParallel(
+        config, [&] { return snake::sim::MakeController(controller_name); });
+
+    std::printf("controller:   %s\n", controller_name.c_str());
+    std::printf("board:        %dx%d\n", config.dim.width, config.dim.height);
+    std::printf("seed:         %llu\n",
+                static_cast<unsigned long long>(config.seed));
+    std::printf("threads:      %d\n", config.num_threads);
+    std::printf("games:        %lld\n", static_cast<long long>(stats.games));
+    std::printf("ticks:        %lld\n", static_cast<long long>(stats.ticks));
+    std::printf("wins:         %lld\n", static_cast<long long>(stats.wins));
+    std::printf("timeouts:     %lld\n", static_cast<long long>(stats.timeouts));
+    std::printf("elapsed:      %.3f s\n", stats.elapsed_sec);
+    std::printf("games/sec:    %.0f\n",
+                static_cast<double>(stats.games) / stats.elapsed_sec);
+    std::printf("ticks/sec:    %.0f\n",
+                static_cast<double>(stats.ticks) / stats.elapsed_sec);
+    PrintScores(stats);
+    PrintLengths(stats, num_buckets);
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <poll.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "game/game.hpp"
+#include "net/protocol.hpp"
+#include "net/socket.hpp"
+
+static void PrintHelp() {
+    std::printf(
+        "Watch a Snake game streamed by snake -l ADDR\n"
+        "\n"
+        "usage: snake_watch [OPTION]... ADDR\n"
+        "ADDR is a TCP port on the local host or the path of a Unix socket.\n"
+        "options:\n"
+        "\t-n NUM    number of spectators to connect (default 1)\n"
+        "\t-p        print the board once the stream ends\n"
+        "\t-h        print this help message\n");
+}
+
+static void PrintBoard(const snake::net::SpectatorView& view) {
+    const snake::game::ScreenDimension kDim = view.GetScreenDimension();
+    const int kBorder = view.GetBorder();
+    std::vector<std::string> rows(static_cast<std::size_t>(kDim.height),
+                                  std::string(kDim.width, '#'));
+    for (int i = kBorder; i < (kDim.height - kBorder); ++i) {
+        for (int j = kBorder; j < (kDim.width - kBorder); ++j) {
+            rows[i][j] = ' ';
+        }
+    }
+
+    auto on_screen = [&kDim](const snake::game::Tile& tile) {
+        return (tile.row >= 0) && (tile.row < kDim.height) &&
+               (tile.col >= 0) && (tile.col < kDim.width);
+    };
+
+    /* draw the head last, it may lie on top of the body if the game is over */
+    const snake::game::Tile& kTarget = view.GetTargetTile();
+    if (on_screen(kTarget)) {
+        rows[kTarget.row][kTarget.col] = '*';
+    }
+    for (const snake::game::Tile& tile : view.GetSnake()) {
+        if (on_screen(tile)) {
+            rows[tile.row][tile.col] = 'o';
+        }
+    }
+    const snake::game::Tile& kHead = view.GetSnake().front();
+    if (on_screen(kHead)) {
+        rows[kHead.row][kHead.col] = '@';
+    }
+
+    for (const std::string& row : rows) {
+        std::printf("%s\n", row.c_str());
+    }
+}
+
+/** Return true if both views hold the same game state. */
+static bool SameState(const snake::net::SpectatorView& a,
+                      const snake::net::SpectatorView& b) {
+    if ((a.HasGame() != b.HasGame()) || (a.GetTicks() != b.GetTicks()) ||
+        (a.GetScore() != b.GetScore()) || (a.GameOver() != b.GameOver()) ||
+        !(a.GetTargetTile() == b.GetTargetTile()) ||
+        (a.GetSnake().size() != b.GetSnake().size())) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.GetSnake().size(); ++i) {
+        const snake::game::Tile& kA = a.GetSnake()[i];
+        const snake::game::Tile& kB = b.GetSnake()[i];
+        if (!(kA == kB) || (kA.direction != kB.direction)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int num_spectators = 1;
+    bool print_board = false;
+
+    int flag = 0;
+    while ((flag = getopt(argc, argv, ":n:ph")) != -1) {
+        switch (flag) {
+            case 'n':
+                num_spectators = std::atoi(optarg);
+                break;
+            case 'p':
+                print_board = true;
+                break;
+            case 'h':
+                PrintHelp();
+                return 0;
+            default:
+                std::fprintf(stderr, "error: invalid option '%c'\n", optopt);
+                PrintHelp();
+                return 1;
+        }
+    }
+    if (((argc - optind) != 1) || (num_spectators < 1)) {
+        std::fprintf(stderr, "error: expected a single address\n");
+        PrintHelp();
+        return 1;
+    }
+    const char* address = argv[optind];
+
+    std::vector<pollfd> fds;
+    for (int i = 0; i < num_spectators; ++i) {
+        const int kFd = snake::net::OpenConnection(address);
+        if (kFd < 0) {
+            std::fprintf(stderr, "error: unable to connect to '%s'\n",
+                         address);
+            return 1;
+        }
+        fds.push_back({.fd = kFd, .events = POLLIN, .revents = 0});
+    }
+
+    /* follow every stream until the game ends and the server hangs up */
+    std::vector<snake::net::SpectatorView> views(fds.size());
+    std::vector<std::uint64_t> bytes(fds.size(), 0);
+    std::vector<std::uint8_t> buffer(64 * 1024);
+    std::size_t num_open = fds.size();
+    while (num_open) {
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            std::perror("error: poll");
+            return 1;
+        }
+        for (std::size_t i = 0; i < fds.size(); ++i) {
+            if ((fds[i].fd < 0) || !fds[i].revents) {
+                continue;
+            }
+            const ssize_t kRead = read(fds[i].fd, buffer.data(), buffer.size());
+            if (kRead > 0) {
+                bytes[i] += static_cast<std::uint64_t>(kRead);
+                if (!views[i].Feed(buffer.data(),
+                                   static_cast<std::size_t>(kRead))) {
+                    std::fprintf(stderr, "error: malformed stream\n");
+                    return 1;
+                }
+                continue;
+            }
+            close(fds[i].fd);
+            fds[i].fd = -1;
+            num_open--;
+        }
+    }
+
+    std::uint64_t total_bytes = 0;
+    std::uint64_t total_frames = 0;
+    std::uint64_t total_snapshots = 0;
+    int num_agree = 0;
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        total_bytes += bytes[i];
+        total_frames += views[i].GetNumFrames();
+        total_snapshots += views[i].GetNumSnapshots();
+        num_agree += SameState(views[i], views[0]) ? 1 : 0;
+    }
+
+    const snake::net::SpectatorView& kView = views[0];
+    std::printf("spectators:   %d\n", num_spectators);
+    std::printf("frames:       %llu\n",
+                static_cast<unsigned long long>(total_frames));
+    std::printf("snapshots:    %llu\n",
+                static_cast<unsigned long long>(total_snapshots));
+    std::printf("bytes:        %llu (%.2f per frame)\n",
+                static_cast<unsigned long long>(total_bytes),
+                total_frames ? (static_cast<double>(total_bytes) /
+                                static_cast<double>(total_frames))
+                             : 0.0);
+    std::printf("agree:        %d of %d\n", num_agree, num_spectators);
+    if (!kView.HasGame()) {
+        return 0;
+    }
+    std::printf("tick %lld  score %d  length %zu%s\n",
+                static_cast<long long>(kView.GetTicks()), kView.GetScore(),
+                kView.GetSnake().size(), kView.GameOver() ? "  game over" : "");
+    if (print_board) {
+        PrintBoard(kView);
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "metrics/alloc_hooks.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::GameState;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+
+/* ticks played and then partly undone per round, which bounds the undo
+ * history */
+static const int kRoundTicks = 16;
+static const int kRoundUndos = 8;
+
+/**
+ * Play a round of the steady-state loop: save the state, tick, undo some of
+ * the ticks and every few rounds restore the saved state, starting a new game
+ * once the game ends.
+ */
+static void PlayRound(SnakeGame& game, GameState& state, Rng& rng,
+                      std::int64_t round) {
+    game.SaveState(state);
+    for (int i = 0; i < kRoundTicks; ++i) {
+        game.Tick(snake::test::ChooseDirection(game.GetSnake()[0],
+                                               game.GetTargetTile(), rng));
+    }
+    game.Undo(std::min<std::size_t>(kRoundUndos, game.GetUndoDepth()));
+    game.ClearUndoHistory();
+    if (0 == (round % 4)) {
+        game.RestoreState(state);
+    }
+    if (game.GameOver()) {
+        game.Reset(static_cast<std::uint64_t>(round));
+    }
+}
+
+/**
+ * Check that once warmed up, ticking, undoing, saving, restoring and
+ * resetting a game never allocate.
+ */
+static void TestSteadyState(const ScreenDimension& dim) {
+    SnakeGame game(dim, 1, Rng(0));
+    game.EnableUndo(true);
+    GameState state;
+    Rng rng(1);
+
+    /* the saved snake and the undo history allocate once, when they first
+     * hold the most Tiles and ticks */
+    const auto kNumPlayable =
+        static_cast<std::size_t>((dim.width - 2) * (dim.height - 2));
+    state.snake.reserve(kNumPlayable);
+    PlayRound(game, state, rng, 1);
+
+    const std::uint64_t kStart = snake::metrics::GetNumAllocations();
+    std::int64_t num_ticks = 0;
+    for (std::int64_t round = 2; round < 20000; ++round) {
+        PlayRound(game, state, rng, round);
+        num_ticks += kRoundTicks;
+    }
+    const std::uint64_t kAllocations =
+        snake::metrics::GetNumAllocations() - kStart;
+    std::printf("%dx%d: %lld ticks, %llu allocations\n", dim.width,
+                dim.height, static_cast<long long>(num_ticks),
+                static_cast<unsigned long long>(kAllocations));
+    CHECK(0 == kAllocations);
+}
+
+int main() {
+    TestSteadyState({.width = 10, .height = 8});
+    TestSteadyState({.width = 80, .height = 24});
+    return 0;
+}
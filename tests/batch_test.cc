@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/game_batch.hpp"
+#include "game/rng.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+using snake::game::SnakeGameBatch;
+using snake::game::SplitMix64;
+using snake::game::Tile;
+
+/** Check that game i of the batch is in the same state as the game. */
+static void CheckSameGame(const SnakeGameBatch& batch, std::size_t i,
+                          const SnakeGame& game) {
+    CHECK(batch.GameOver(i) == game.GameOver());
+    CHECK(batch.SnakeWins(i) == game.SnakeWins());
+    CHECK(batch.GetScore(i) == game.GetScore());
+    CHECK(batch.GetLength(i) == game.GetSnake().size());
+    CHECK(batch.GetTargetTile(i) == game.GetTargetTile());
+
+    const Tile kHead = batch.GetSnakeTile(i, 0);
+    CHECK(kHead == game.GetSnake()[0]);
+    CHECK(kHead.direction == game.GetSnake()[0].direction);
+    for (std::size_t j = 1; j < game.GetSnake().size(); ++j) {
+        CHECK(batch.GetSnakeTile(i, j) == game.GetSnake()[j]);
+    }
+}
+
+/**
+ * Play num_games seeded games on the parameter board through a batch and
+ * through as many SnakeGames with the same directions, restarting finished
+ * games with fresh seeds, and check the games stay identical.
+ */
+static void TestBoard(const ScreenDimension& dim, std::size_t num_games,
+                      int num_ticks) {
+    const int kBorder = 1;
+    SnakeGameBatch batch(dim, num_games, kBorder);
+    std::vector<SnakeGame> games(num_games, SnakeGame(dim, kBorder, Rng(0)));
+    std::vector<Direction> directions(num_games);
+    Rng rng(static_cast<std::uint64_t>(dim.width * 1000 + dim.height));
+
+    std::uint64_t next_seed = 0;
+    auto restart = [&](std::size_t i) {
+        const std::uint64_t kSeed = SplitMix64(next_seed++);
+        batch.Reset(i, kSeed);
+        games[i].Reset(kSeed);
+    };
+    for (std::size_t i = 0; i < num_games; ++i) {
+        restart(i);
+        CheckSameGame(batch, i, games[i]);
+    }
+
+    std::int64_t num_wins = 0;
+    for (int tick = 0; tick < num_ticks; ++tick) {
+        for (std::size_t i = 0; i < num_games; ++i) {
+            directions[i] = snake::test::ChooseDirection(
+                games[i].GetSnake()[0], games[i].GetTargetTile(), rng);
+        }
+        batch.Tick(directions.data());
+        for (std::size_t i = 0; i < num_games; ++i) {
+            games[i].Tick(directions[i]);
+            CheckSameGame(batch, i, games[i]);
+            if (games[i].GameOver()) {
+                num_wins += games[i].SnakeWins() ? 1 : 0;
+                restart(i);
+                CheckSameGame(batch, i, games[i]);
+            }
+        }
+    }
+    std::printf("%dx%d: %zu games, %llu started, %lld won\n", dim.width,
+                dim.height, num_games,
+                static_cast<unsigned long long>(next_seed),
+                static_cast<long long>(num_wins));
+}
+
+int main() {
+    /* the small boards are won now and then, which exercises the end of
+     * the game with no free Tile left for a target, a single playable Tile
+     * is won as soon as the snake spawns */
+    TestBoard({.width = 3, .height = 3}, 16, 10);
+    TestBoard({.width = 4, .height = 3}, 64, 2000);
+    TestBoard({.width = 4, .height = 5}, 64, 2000);
+    TestBoard({.width = 6, .height = 6}, 64, 2000);
+    TestBoard({.width = 20, .height = 12}, 64, 2000);
+    TestBoard({.width = 80, .height = 24}, 16, 2000);
+    return 0;
+}
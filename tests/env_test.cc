@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "game/env.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "metrics/alloc_hooks.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::EnvConfig;
+using snake::game::Observation;
+using snake::game::Rng;
+using snake::game::SnakeEnv;
+using snake::game::SnakeVecEnv;
+using snake::game::SplitMix64;
+using snake::game::StepResult;
+
+/**
+ * Check that every observation of the vectorized environments matches that
+ * of the SnakeEnvs, float for float.
+ */
+static void CheckSameObservations(const SnakeVecEnv& vec_env,
+                                  const std::vector<SnakeEnv>& envs,
+                                  std::vector<float>& vec_out,
+                                  std::vector<float>& out) {
+    for (const Observation kObservation :
+         {Observation::kGrid, Observation::kFeatures, Observation::kRays}) {
+        const std::size_t kSize = vec_env.GetObservationSize(kObservation);
+        vec_env.Observe(kObservation, vec_out.data());
+        for (std::size_t i = 0; i < envs.size(); ++i) {
+            CHECK(envs[i].GetObservationSize(kObservation) == kSize);
+            envs[i].Observe(kObservation, out.data());
+            for (std::size_t j = 0; j < kSize; ++j) {
+                CHECK(vec_out[i * kSize + j] == out[j]);
+            }
+        }
+    }
+}
+
+/**
+ * Step num_envs vectorized environments and as many SnakeEnvs with the same
+ * actions, resetting a SnakeEnv with SplitMix64(seed + k) whenever the k-th
+ * episode starts, and check that rewards, done flags and observations stay
+ * identical. Also check that stepping and observing the vectorized
+ * environments never allocate.
+ */
+static void TestVecEnv(const EnvConfig& config, std::size_t num_envs,
+                       std::uint64_t seed, int num_steps) {
+    SnakeVecEnv vec_env(config, num_envs);
+    std::vector<SnakeEnv> envs(num_envs, SnakeEnv(config));
+    vec_env.Reset(seed);
+    std::uint64_t next_episode = 0;
+    for (SnakeEnv& env : envs) {
+        env.Reset(SplitMix64(seed + next_episode++));
+    }
+
+    std::size_t max_size = 0;
+    for (const Observation kObservation :
+         {Observation::kGrid, Observation::kFeatures, Observation::kRays}) {
+        max_size =
+            std::max(max_size, vec_env.GetObservationSize(kObservation));
+    }
+    std::vector<float> vec_out(num_envs * max_size);
+    std::vector<float> out(max_size);
+    std::vector<Direction> actions(num_envs);
+    std::vector<float> rewards(num_envs);
+    std::vector<std::uint8_t> dones(num_envs);
+    CheckSameObservations(vec_env, envs, vec_out, out);
+
+    Rng rng(seed);
+    std::int64_t num_ended = 0;
+    std::int64_t num_truncated = 0;
+    std::uint64_t num_allocations = 0;
+    for (int step = 0; step < num_steps; ++step) {
+        for (std::size_t i = 0; i < num_envs; ++i) {
+            const snake::game::SnakeGame& game = envs[i].GetGame();
+            actions[i] = snake::test::ChooseDirection(
+                game.GetSnake()[0], game.GetTargetTile(), rng);
+        }
+
+        const std::uint64_t kStart = snake::metrics::GetNumAllocations();
+        vec_env.Step(actions.data(), rewards.data(), dones.data());
+        vec_env.Observe(Observation::kGrid, vec_out.data());
+        num_allocations += snake::metrics::GetNumAllocations() - kStart;
+
+        for (std::size_t i = 0; i < num_envs; ++i) {
+            const StepResult kResult = envs[i].Step(actions[i]);
+            CHECK(rewards[i] == kResult.reward);
+            CHECK(dones[i] ==
+                  (kResult.done ? (kResult.truncated ? 2 : 1) : 0));
+            if (kResult.done) {
+                envs[i].Reset(SplitMix64(seed + next_episode++));
+                num_ended += kResult.truncated ? 0 : 1;
+                num_truncated += kResult.truncated ? 1 : 0;
+            }
+        }
+        CheckSameObservations(vec_env, envs, vec_out, out);
+    }
+    std::printf(
+        "%dx%d idle %lld: %zu envs, %d steps, %lld ended, %lld truncated, "
+        "%llu allocations\n",
+        config.dim.width, config.dim.height,
+        static_cast<long long>(config.max_idle_ticks), num_envs, num_steps,
+        static_cast<long long>(num_ended),
+        static_cast<long long>(num_truncated),
+        static_cast<unsigned long long>(num_allocations));
+    CHECK(num_ended > 0);
+    CHECK((config.max_idle_ticks > 0) == (num_truncated > 0));
+    CHECK(0 == num_allocations);
+}
+
+int main() {
+    EnvConfig config;
+    config.dim = {.width = 12, .height = 9};
+    config.tick_reward = -0.01F;
+    TestVecEnv(config, 16, 1, 2000);
+
+    config.max_idle_ticks = 20;
+    TestVecEnv(config, 16, 2, 2000);
+
+    config.dim = {.width = 30, .height = 20};
+    config.border = 2;
+    config.max_idle_ticks = 40;
+    config.target_reward = 0.5F;
+    config.death_reward = -2.0F;
+    TestVecEnv(config, 8, 3, 2000);
+    return 0;
+}
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "game/basic_game.hpp"
+#include "game/game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "test_util.hpp"
+
+using snake::game::BasicSnakeGame;
+using snake::game::Direction;
+using snake::game::GameState;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+using snake::game::SplitMix64;
+using snake::game::Tile;
+
+/**
+ * Straightforward model of the rules SnakeGame implements, the way the game
+ * was first written: the whole body shifts each tick and collisions and wins
+ * are found by comparing every pair of Tiles, so each tick costs O(n^2) in
+ * the length of the snake.
+ *
+ * Targets are random, so they are taken from the SnakeGame under test, the
+ * model only checks that each lands on a free Tile.
+ */
+class ReferenceGame {
+   public:
+    ReferenceGame(const ScreenDimension& dim, int border, const Tile& head,
+                  const Tile& target)
+        : dim_(dim), border_(border), snake_{head}, target_(target) {
+        CheckTarget();
+    }
+
+    int GetScore() const { return score_; }
+    std::int64_t GetTicks() const { return ticks_; }
+    bool GameOver() const { return game_over_; }
+    bool SnakeWins() const { return wins_; }
+    const std::vector<Tile>& GetSnake() const { return snake_; }
+
+    /**
+     * Advance the game one tick.
+     *
+     * @returns true if the snake ate the target and a new one is needed.
+     */
+    bool Tick(Direction direction) {
+        if (game_over_) {
+            return false;
+        }
+        if (Direction::kNone == direction) {
+            direction = snake_.front().direction;
+        }
+
+        const std::vector<Tile> kPrev = snake_;
+        for (std::size_t i = 1; i < snake_.size(); ++i) {
+            snake_[i] = kPrev[i - 1];
+        }
+        snake_.front() = snake::game::Neighbor(kPrev.front(), direction);
+        snake_.front().direction = direction;
+        ticks_++;
+
+        if (!IsInBounds(snake_.front()) || Overlaps()) {
+            game_over_ = true;
+            return false;
+        }
+        if (!(snake_.front() == target_)) {
+            return false;
+        }
+
+        score_ += kScoreIncrement;
+        const Tile kTail = snake_.back();
+        snake_.push_back(snake::game::Neighbor(
+            kTail, snake::game::Opposite(kTail.direction)));
+        if (CoversBoard()) {
+            wins_ = true;
+            game_over_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void SetTarget(const Tile& target) {
+        target_ = target;
+        CheckTarget();
+    }
+
+   private:
+    static const int kScoreIncrement = 10;
+
+    bool IsInBounds(const Tile& tile) const {
+        return (tile.row >= border_) && (tile.row < (dim_.height - border_)) &&
+               (tile.col >= border_) && (tile.col < (dim_.width - border_));
+    }
+
+    bool Overlaps() const {
+        for (std::size_t i = 0; i < snake_.size(); ++i) {
+            for (std::size_t j = i + 1; j < snake_.size(); ++j) {
+                if (snake_[i] == snake_[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool CoversBoard() const {
+        for (int row = border_; row < (dim_.height - border_); ++row) {
+            for (int col = border_; col < (dim_.width - border_); ++col) {
+                if (!IsOnSnake({.row = row, .col = col})) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool IsOnSnake(const Tile& tile) const {
+        for (const Tile& snake_tile : snake_) {
+            if (snake_tile == tile) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void CheckTarget() const {
+        CHECK(IsInBounds(target_));
+        CHECK(!IsOnSnake(target_));
+    }
+
+    ScreenDimension dim_;
+    int border_ = 1;
+    std::vector<Tile> snake_;
+    Tile target_;
+    int score_ = 0;
+    std::int64_t ticks_ = 0;
+    bool game_over_ = false;
+    bool wins_ = false;
+};
+
+/**
+ * Play a seeded game in both implementations with the directions returned
+ * by next_direction and check that every tick has the same outcome.
+ *
+ * @returns the tick the game ended on or -1 if it still ran after max_ticks.
+ */
+template <typename NextDirection>
+static std::int64_t Replay(SnakeGame& game, std::uint64_t seed,
+                           std::int64_t max_ticks,
+                           NextDirection next_direction) {
+    game.Reset(seed);
+    const ScreenDimension kDim = game.GetScreenDimension();
+    const Tile kHead = game.GetSnake()[0];
+    CHECK((kDim.height / 2 == kHead.row) && (kDim.width / 2 == kHead.col));
+    ReferenceGame reference(kDim, game.GetBorder(), kHead,
+                            game.GetTargetTile());
+
+    for (std::int64_t tick = 0; tick < max_ticks; ++tick) {
+        const Direction kDirection = next_direction(game);
+        game.Tick(kDirection);
+        if (reference.Tick(kDirection)) {
+            reference.SetTarget(game.GetTargetTile());
+        }
+
+        CHECK(game.GetScore() == reference.GetScore());
+        CHECK(game.GetTicks() == reference.GetTicks());
+        CHECK(game.GameOver() == reference.GameOver());
+        CHECK(game.SnakeWins() == reference.SnakeWins());
+        CHECK(game.GetSnake().size() == reference.GetSnake().size());
+        for (std::size_t i = 0; i < game.GetSnake().size(); ++i) {
+            CHECK(game.GetSnake()[i] == reference.GetSnake()[i]);
+        }
+        if (game.GameOver()) {
+            return game.GetTicks();
+        }
+    }
+    return -1;
+}
+
+/** Check that a board of a single playable Tile is won without a tick. */
+static void TestSingleTile() {
+    SnakeGame game({.width = 3, .height = 3}, 1, Rng(0));
+    for (std::uint64_t seed = 0; seed < 8; ++seed) {
+        game.Reset(seed);
+        CHECK(game.GameOver() && game.SnakeWins());
+        CHECK(game.GetTargetTile() == game.GetSnake()[0]);
+        game.Tick(Direction::kUp);
+        CHECK((0 == game.GetTicks()) && (0 == game.GetScore()));
+        CHECK(1 == game.GetSnake().size());
+    }
+}
+
+/** Replay fixed direction sequences, repeated until the game ends. */
+static void TestSequences() {
+    const std::vector<std::vector<Direction>> kSequences = {
+        {Direction::kNone},
+        {Direction::kUp, Direction::kDown},
+        {Direction::kUp, Direction::kRight, Direction::kDown, Direction::kLeft},
+        {Direction::kLeft, Direction::kLeft, Direction::kUp, Direction::kUp,
+         Direction::kRight, Direction::kRight, Direction::kDown,
+         Direction::kNone},
+    };
+    SnakeGame game({.width = 12, .height = 9}, 1, Rng(0));
+    for (std::size_t i = 0; i < kSequences.size(); ++i) {
+        const std::vector<Direction>& kSequence = kSequences[i];
+        for (std::uint64_t seed = 0; seed < 16; ++seed) {
+            std::size_t next = 0;
+            (void)Replay(game, seed, 10000, [&](const SnakeGame&) {
+                return kSequence[next++ % kSequence.size()];
+            });
+        }
+    }
+}
+
+/** Replay seeded games played by a snake chasing its target. */
+static void TestBoard(const ScreenDimension& dim, int num_games) {
+    SnakeGame game(dim, 1, Rng(0));
+    std::int64_t num_ended = 0;
+    std::int64_t num_won = 0;
+    std::int64_t num_ticks = 0;
+    std::size_t max_length = 0;
+    for (int i = 0; i < num_games; ++i) {
+        const std::uint64_t kSeed = SplitMix64(static_cast<std::uint64_t>(i));
+        Rng rng(kSeed);
+        const std::int64_t kEndTick =
+            Replay(game, kSeed, 20000, [&](const SnakeGame& g) {
+                /* an occasional blunder ends the games on larger boards */
+                if (rng.Below(64) == 0) {
+                    return snake::test::ChooseDirection(
+                        g.GetSnake()[0], g.GetTargetTile(), rng);
+                }
+                return snake::test::ChooseSafeDirection(g, rng);
+            });
+        num_ended += (kEndTick >= 0) ? 1 : 0;
+        num_won += game.SnakeWins() ? 1 : 0;
+        num_ticks += game.GetTicks();
+        max_length = std::max(max_length, game.GetSnake().size());
+    }
+    std::printf(
+        "%dx%d: %d games, %lld ended, %lld won, %lld ticks, longest snake "
+        "%zu\n",
+        dim.width, dim.height, num_games, static_cast<long long>(num_ended),
+        static_cast<long long>(num_won), static_cast<long long>(num_ticks),
+        max_length);
+}
+
+/** Check that a BasicSnakeGame is in the same state as a SnakeGame. */
+template <typename Basic>
+static void CheckSameGame(const Basic& basic, const SnakeGame& game) {
+    CHECK(basic.GetScore() == game.GetScore());
+    CHECK(basic.GetTicks() == game.GetTicks());
+    CHECK(basic.GameOver() == game.GameOver());
+    CHECK(basic.SnakeWins() == game.SnakeWins());
+    CHECK(basic.GetTargetTile() == game.GetTargetTile());
+    CHECK(basic.GetSnake().size() == game.GetSnake().size());
+    for (std::size_t i = 0; i < game.GetSnake().size(); ++i) {
+        CHECK(basic.GetSnake()[i] == game.GetSnake()[i]);
+        CHECK(basic.GetSnake()[i].direction == game.GetSnake()[i].direction);
+    }
+
+    if (game.GetTicks() > 0) {
+        const snake::game::TickDelta& basic_delta = basic.GetLastDelta();
+        const snake::game::TickDelta& delta = game.GetLastDelta();
+        CHECK(basic_delta.head == delta.head);
+        CHECK(basic_delta.head.direction == delta.head.direction);
+        CHECK(basic_delta.prev_head == delta.prev_head);
+        CHECK(basic_delta.vacated_tail == delta.vacated_tail);
+        CHECK(basic_delta.tail_vacated == delta.tail_vacated);
+        CHECK(basic_delta.target_moved == delta.target_moved);
+    }
+
+    /* the ring of Tiles just off the screen included */
+    const ScreenDimension kDim = game.GetScreenDimension();
+    for (int row = -1; row <= kDim.height; ++row) {
+        for (int col = -1; col <= kDim.width; ++col) {
+            const Tile kTile = {.row = row, .col = col};
+            CHECK(Basic::IsInBounds(kTile) == game.IsInBounds(kTile));
+            CHECK(basic.IsFree(kTile) == game.IsFree(kTile));
+        }
+    }
+}
+
+/**
+ * Play seeded games in a BasicSnakeGame and a SnakeGame of the same board
+ * with the same directions and check that every tick plays out identically.
+ */
+template <int Width, int Height, int Border>
+static void TestBasicGame(int num_games) {
+    using Basic = BasicSnakeGame<Width, Height, Border>;
+
+    /* the fixed size game holds the whole board, keep it off the stack */
+    auto basic = std::make_unique<Basic>(Rng(0));
+    SnakeGame game(Basic::GetScreenDimension(), Border, Rng(0));
+    std::int64_t num_ticks = 0;
+    for (int i = 0; i < num_games; ++i) {
+        const std::uint64_t kSeed = SplitMix64(static_cast<std::uint64_t>(i));
+        Rng rng(kSeed);
+        basic->Reset(kSeed);
+        game.Reset(kSeed);
+        CheckSameGame(*basic, game);
+        while (!game.GameOver() && (game.GetTicks() < 20000)) {
+            /* an occasional blunder ends the games on larger boards */
+            const Direction kDirection =
+                (rng.Below(64) == 0)
+                    ? snake::test::ChooseDirection(game.GetSnake()[0],
+                                                   game.GetTargetTile(), rng)
+                    : snake::test::ChooseSafeDirection(game, rng);
+            basic->Tick(kDirection);
+            game.Tick(kDirection);
+            CheckSameGame(*basic, game);
+        }
+
+        /* ticking a finished game changes nothing */
+        basic->Tick(Direction::kUp);
+        game.Tick(Direction::kUp);
+        CheckSameGame(*basic, game);
+        num_ticks += game.GetTicks();
+    }
+    std::printf("basic %dx%d border %d: %d games, %lld ticks\n", Width,
+                Height, Border, num_games, static_cast<long long>(num_ticks));
+}
+
+/** Check that two generators are at the same point of their sequence. */
+static bool SameRng(Rng a, Rng b) {
+    for (int i = 0; i < 4; ++i) {
+        if (a() != b()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SameDelta(const snake::game::TickDelta& a,
+                      const snake::game::TickDelta& b) {
+    return (a.head == b.head) && (a.head.direction == b.head.direction) &&
+           (a.prev_head == b.prev_head) && (a.vacated_tail == b.vacated_tail) &&
+           (a.tail_vacated == b.tail_vacated) &&
+           (a.target_moved == b.target_moved);
+}
+
+/** Check that the game is in the parameter saved state. */
+static void CheckState(const SnakeGame& game, const GameState& expected) {
+    GameState state;
+    game.SaveState(state);
+    CHECK(state.snake.size() == expected.snake.size());
+    for (std::size_t i = 0; i < state.snake.size(); ++i) {
+        CHECK(state.snake[i] == expected.snake[i]);
+        CHECK(state.snake[i].direction == expected.snake[i].direction);
+    }
+    CHECK(state.target == expected.target);
+    CHECK(SameDelta(state.last_delta, expected.last_delta));
+    CHECK(SameRng(state.rng, expected.rng));
+    CHECK(state.score == expected.score);
+    CHECK(state.ticks == expected.ticks);
+    CHECK(state.game_over == expected.game_over);
+}
+
+/**
+ * Play seeded games saving the state after every tick and repeatedly undo a
+ * random number of ticks. Check that each undo returns to the saved state of
+ * that tick and that replaying the undone directions passes through the same
+ * states again, spawning the same targets, before play carries on in new
+ * directions.
+ */
+static void TestUndo(const ScreenDimension& dim, int num_games) {
+    SnakeGame game(dim, 1, Rng(0));
+    game.EnableUndo(true);
+    std::vector<GameState> states; /* states[i] is the state after i ticks */
+    std::vector<Direction> directions; /* directions[i] played tick i + 1 */
+    std::int64_t num_undone = 0;
+    std::int64_t num_replayed = 0;
+    for (int i = 0; i < num_games; ++i) {
+        const std::uint64_t kSeed = SplitMix64(static_cast<std::uint64_t>(i));
+        Rng rng(kSeed);
+        game.Reset(kSeed);
+        states.assign(1, GameState());
+        game.SaveState(states[0]);
+        directions.clear();
+
+        for (int round = 0; round < 64; ++round) {
+            for (auto tick = static_cast<int>(rng.Below(32));
+                 (tick > 0) && !game.GameOver(); --tick) {
+                directions.push_back(
+                    (rng.Below(16) == 0)
+                        ? snake::test::ChooseDirection(
+                              game.GetSnake()[0], game.GetTargetTile(), rng)
+                        : snake::test::ChooseSafeDirection(game, rng));
+                game.Tick(directions.back());
+                states.emplace_back();
+                game.SaveState(states.back());
+            }
+            CHECK(game.GetUndoDepth() ==
+                  static_cast<std::size_t>(game.GetTicks()));
+
+            /* a game which ended is always taken back at least a tick */
+            const std::size_t kDepth = game.GetUndoDepth();
+            const std::size_t kUndo =
+                std::max<std::size_t>(game.GameOver() ? 1 : 0,
+                                      rng.Below(static_cast<std::uint32_t>(
+                                          std::min<std::size_t>(kDepth, 48) +
+                                          1)));
+            const std::size_t kTick = kDepth - kUndo;
+            game.Undo(kUndo);
+            CHECK(game.GetUndoDepth() == kTick);
+            CheckState(game, states[kTick]);
+            num_undone += static_cast<std::int64_t>(kUndo);
+
+            const std::size_t kReplay = rng.Below(
+                static_cast<std::uint32_t>(kUndo + 1));
+            for (std::size_t j = kTick; j < kTick + kReplay; ++j) {
+                game.Tick(directions[j]);
+                CheckState(game, states[j + 1]);
+            }
+            num_replayed += static_cast<std::int64_t>(kReplay);
+            directions.resize(kTick + kReplay);
+            states.resize(kTick + kReplay + 1);
+        }
+
+        /* the whole game is taken back to its first state */
+        game.Undo(game.GetUndoDepth());
+        CheckState(game, states[0]);
+    }
+    std::printf("undo %dx%d: %d games, %lld ticks undone, %lld replayed\n",
+                dim.width, dim.height, num_games,
+                static_cast<long long>(num_undone),
+                static_cast<long long>(num_replayed));
+}
+
+int main() {
+    TestSingleTile();
+    TestSequences();
+    TestBoard({.width = 4, .height = 5}, 500);
+    TestBoard({.width = 10, .height = 8}, 500);
+    TestBoard({.width = 40, .height = 20}, 200);
+    TestBasicGame<3, 3, 1>(8);
+    TestBasicGame<4, 5, 1>(300);
+    TestBasicGame<9, 7, 0>(300);
+    TestBasicGame<12, 9, 2>(200);
+    TestBasicGame<40, 20, 1>(40);
+    TestBasicGame<80, 24, 1>(10);
+    TestUndo({.width = 5, .height = 5}, 200);
+    TestUndo({.width = 12, .height = 9}, 100);
+    TestUndo({.width = 40, .height = 20}, 30);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "game/rng.hpp"
+#include "metrics/metrics.hpp"
+#include "test_util.hpp"
+
+using snake::game::Rng;
+using snake::metrics::Histogram;
+
+static const std::uint64_t kMaxValue =
+    std::numeric_limits<std::uint64_t>::max();
+
+/**
+ * Check that the buckets tile the whole 64-bit range without gaps, that
+ * both bounds of every bucket are counted in that bucket and that no bucket
+ * is wider than 1 / kSubBuckets of its lower bound.
+ */
+static void TestBuckets() {
+    CHECK(0 == Histogram::BucketLowerBound(0));
+    CHECK(kMaxValue == Histogram::BucketUpperBound(Histogram::kNumBuckets - 1));
+
+    Histogram histogram;
+    for (int i = 0; i < Histogram::kNumBuckets; ++i) {
+        const std::uint64_t kLower = Histogram::BucketLowerBound(i);
+        const std::uint64_t kUpper = Histogram::BucketUpperBound(i);
+        CHECK(kLower <= kUpper);
+        if (i > 0) {
+            CHECK(kLower == Histogram::BucketUpperBound(i - 1) + 1);
+        }
+        if (kLower >= Histogram::kSubBuckets) {
+            CHECK((kUpper - kLower) < (kLower / Histogram::kSubBuckets));
+        }
+
+        histogram.Clear();
+        histogram.Record(kLower);
+        histogram.Record(kUpper);
+        CHECK(2 == histogram.GetBucketCount(i));
+    }
+
+    /* the top of the range, where the shifts reach bit 63 */
+    const std::uint64_t kTopBit = std::uint64_t{1} << 63;
+    histogram.Clear();
+    histogram.Record(kTopBit);
+    histogram.Record(kMaxValue);
+    CHECK(1 == histogram.GetBucketCount(Histogram::kNumBuckets -
+                                        Histogram::kSubBuckets));
+    CHECK(1 == histogram.GetBucketCount(Histogram::kNumBuckets - 1));
+    CHECK(kTopBit == histogram.GetMin());
+    CHECK(kMaxValue == histogram.GetMax());
+    CHECK(Histogram::BucketUpperBound(Histogram::kNumBuckets -
+                                      Histogram::kSubBuckets) ==
+          histogram.GetValueAtQuantile(0.0));
+    CHECK(kMaxValue == histogram.GetValueAtQuantile(1.0));
+}
+
+/**
+ * Check the quantiles of 100k samples spread over the whole 64-bit range
+ * against the exact ones: a quantile never lies below the true sample and
+ * at most 1 / kSubBuckets above it.
+ */
+static void TestQuantiles() {
+    const int kNumSamples = 100000;
+    Rng rng(1);
+    Histogram histogram;
+    std::vector<std::uint64_t> samples;
+    samples.reserve(kNumSamples);
+    for (int i = 0; i < kNumSamples; ++i) {
+        /* about as many samples in every power of two range */
+        const std::uint64_t kValue = rng() >> rng.Below(64);
+        samples.push_back(kValue);
+        histogram.Record(kValue);
+    }
+    std::sort(samples.begin(), samples.end());
+    CHECK(kNumSamples == histogram.GetCount());
+    CHECK(samples.front() == histogram.GetMin());
+    CHECK(samples.back() == histogram.GetMax());
+
+    for (const double kQuantile :
+         {0.0, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+        const auto kRank = std::max<std::size_t>(
+            1, static_cast<std::size_t>(kQuantile * kNumSamples + 0.5));
+        const std::uint64_t kExact = samples[kRank - 1];
+        const std::uint64_t kValue = histogram.GetValueAtQuantile(kQuantile);
+        CHECK(kValue >= kExact);
+        CHECK((kValue - kExact) <= (kExact / Histogram::kSubBuckets));
+    }
+
+    /* out of range quantiles are clamped to the smallest and largest */
+    CHECK(histogram.GetValueAtQuantile(-1.0) ==
+          histogram.GetValueAtQuantile(0.0));
+    CHECK(histogram.GetValueAtQuantile(2.0) == samples.back());
+}
+
+/**
+ * Check that quantiles report the upper bound of their bucket clamped to the
+ * largest sample, and 0 for an empty histogram.
+ */
+static void TestClamping() {
+    Histogram histogram;
+    CHECK(0 == histogram.GetValueAtQuantile(0.5));
+
+    /* both samples share the bucket [992, 1023] */
+    histogram.Record(1000);
+    histogram.Record(1001);
+    CHECK(992 == Histogram::BucketLowerBound(111));
+    CHECK(1023 == Histogram::BucketUpperBound(111));
+    CHECK(2 == histogram.GetBucketCount(111));
+    CHECK(1001 == histogram.GetValueAtQuantile(0.0));
+    CHECK(1001 == histogram.GetValueAtQuantile(0.5));
+    CHECK(1001 == histogram.GetValueAtQuantile(1.0));
+
+    histogram.Clear();
+    CHECK((0 == histogram.GetCount()) && (0 == histogram.GetMax()));
+    CHECK(0 == histogram.GetValueAtQuantile(1.0));
+    histogram.Record(0);
+    CHECK(0 == histogram.GetValueAtQuantile(1.0));
+}
+
+int main() {
+    TestBuckets();
+    TestQuantiles();
+    TestClamping();
+    std::printf("%d buckets checked\n", Histogram::kNumBuckets);
+    return 0;
+}
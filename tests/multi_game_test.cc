@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "game/multi_game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::MultiSnakeGame;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SplitMix64;
+using snake::game::Tile;
+
+/** Occurrences of the collision rules worth covering, see ReferenceGame. */
+struct RuleCounts {
+    std::int64_t ticks = 0;
+    std::int64_t head_on = 0;    /**< Several heads claimed one Tile. */
+    std::int64_t kept_tail = 0;  /**< A head moved onto the tail of another
+                                      snake which ate and kept it. */
+    std::int64_t freed_tail = 0; /**< A head moved onto the tail of another
+                                      snake which moved on. */
+    std::int64_t swaps = 0;      /**< A 1-tile snake swapped Tiles with
+                                      another and survived. */
+    std::int64_t eaten = 0;
+    std::int64_t deaths = 0;
+};
+
+/**
+ * Straightforward model of the rules MultiSnakeGame implements: every
+ * collision is found by comparing the new heads with every Tile of every
+ * snake, so each tick costs O(n^2) in the total length of the snakes.
+ *
+ * Targets are random, so the ones spawned after a tick are taken from the
+ * MultiSnakeGame under test, the model only checks that the targets left
+ * uneaten stay put and the new ones land on free Tiles.
+ */
+class ReferenceGame {
+   public:
+    ReferenceGame(const MultiSnakeGame& game, std::size_t num_targets)
+        : dim_(game.GetScreenDimension()),
+          border_(game.GetBorder()),
+          num_targets_(num_targets),
+          snakes_(game.GetNumSnakes()),
+          alive_(game.GetNumSnakes()),
+          scores_(game.GetNumSnakes()) {
+        for (std::size_t i = 0; i < snakes_.size(); ++i) {
+            const snake::game::Snake& snake = game.GetSnake(i);
+            snakes_[i].assign(snake.begin(), snake.end());
+            alive_[i] = game.IsAlive(i);
+            scores_[i] = game.GetScore(i);
+        }
+        targets_ = game.GetTargets();
+        Check(game);
+    }
+
+    /** Advance every living snake one Tile, see MultiSnakeGame::Tick(). */
+    void Tick(const Direction* directions, RuleCounts& counts) {
+        const std::size_t kNumSnakes = snakes_.size();
+        std::vector<Tile> heads(kNumSnakes);
+        std::vector<bool> eats(kNumSnakes, false);
+        for (std::size_t i = 0; i < kNumSnakes; ++i) {
+            if (!alive_[i]) {
+                continue;
+            }
+            const Direction kDirection = (Direction::kNone == directions[i])
+                                             ? snakes_[i].front().direction
+                                             : directions[i];
+            heads[i] = snake::game::Neighbor(snakes_[i].front(), kDirection);
+            heads[i].direction = kDirection;
+            eats[i] = IsInBounds(heads[i]) && IsTarget(heads[i]);
+        }
+
+        /* (1) tails of the snakes that don't eat leave, (2) a head dies on
+         * the wall, on any Tile still covered or on another new head */
+        std::vector<bool> dies(kNumSnakes, false);
+        std::vector<std::size_t> swapped;
+        for (std::size_t i = 0; i < kNumSnakes; ++i) {
+            if (!alive_[i]) {
+                continue;
+            }
+            dies[i] = !IsInBounds(heads[i]);
+            for (std::size_t j = 0; j < kNumSnakes; ++j) {
+                if (!alive_[j]) {
+                    continue;
+                }
+                const std::size_t kKept =
+                    snakes_[j].size() - (eats[j] ? 0 : 1);
+                for (std::size_t k = 0; k < kKept; ++k) {
+                    dies[i] = dies[i] || (heads[i] == snakes_[j][k]);
+                }
+                if (j == i) {
+                    continue;
+                }
+                if (heads[i] == heads[j]) {
+                    dies[i] = true;
+                    counts.head_on++;
+                }
+                if (heads[i] == snakes_[j].back()) {
+                    (eats[j] ? counts.kept_tail : counts.freed_tail)++;
+                }
+                if ((1 == snakes_[i].size()) && (1 == snakes_[j].size()) &&
+                    (heads[i] == snakes_[j].front()) &&
+                    (heads[j] == snakes_[i].front())) {
+                    swapped.push_back(i);
+                }
+            }
+        }
+        for (std::size_t i : swapped) {
+            counts.swaps += dies[i] ? 0 : 1;
+        }
+
+        /* (3) the survivors move and eat, (4) the dead are cleared */
+        for (std::size_t i = 0; i < kNumSnakes; ++i) {
+            if (!alive_[i]) {
+                continue;
+            }
+            if (dies[i]) {
+                snakes_[i].clear();
+                alive_[i] = false;
+                counts.deaths++;
+                continue;
+            }
+            snakes_[i].insert(snakes_[i].begin(), heads[i]);
+            if (eats[i]) {
+                targets_.erase(
+                    std::find(targets_.begin(), targets_.end(), heads[i]));
+                scores_[i] += kScoreIncrement;
+                counts.eaten++;
+            } else {
+                snakes_[i].pop_back();
+            }
+        }
+        counts.ticks++;
+    }
+
+    /**
+     * Check that the game is in the model's state and take over the targets
+     * it spawned.
+     */
+    void Check(const MultiSnakeGame& game) {
+        std::size_t num_alive = 0;
+        for (std::size_t i = 0; i < snakes_.size(); ++i) {
+            CHECK(game.IsAlive(i) == alive_[i]);
+            CHECK(game.GetScore(i) == scores_[i]);
+            const snake::game::Snake& snake = game.GetSnake(i);
+            CHECK(snake.size() == snakes_[i].size());
+            for (std::size_t j = 0; j < snake.size(); ++j) {
+                CHECK(snake[j] == snakes_[i][j]);
+                CHECK(snake[j].direction == snakes_[i][j].direction);
+            }
+            num_alive += alive_[i] ? 1 : 0;
+        }
+        CHECK(game.GetNumAlive() == num_alive);
+
+        /* the owner grid agrees with the bodies, tiles off the board
+         * included */
+        std::size_t num_free = 0;
+        for (int row = -1; row <= dim_.height; ++row) {
+            for (int col = -1; col <= dim_.width; ++col) {
+                const Tile kTile = {.row = row, .col = col};
+                const int kOwner = GetOwner(kTile);
+                CHECK(game.GetOwner(kTile) == kOwner);
+                CHECK(game.IsFree(kTile) ==
+                      (IsInBounds(kTile) &&
+                       (MultiSnakeGame::kNoSnake == kOwner)));
+                num_free += (game.IsFree(kTile) && !IsTarget(kTile)) ? 1 : 0;
+            }
+        }
+
+        /* targets left uneaten stay put, new ones fill up free Tiles */
+        const std::vector<Tile>& targets = game.GetTargets();
+        CHECK(targets.size() ==
+              std::min(num_targets_, targets_.size() + num_free));
+        for (const Tile& target : targets_) {
+            CHECK(std::count(targets.begin(), targets.end(), target) == 1);
+        }
+        for (const Tile& target : targets) {
+            CHECK(game.IsFree(target));
+            CHECK(std::count(targets.begin(), targets.end(), target) == 1);
+        }
+        targets_ = targets;
+    }
+
+   private:
+    static const int kScoreIncrement = 10;
+
+    bool IsInBounds(const Tile& tile) const {
+        return (tile.row >= border_) && (tile.row < (dim_.height - border_)) &&
+               (tile.col >= border_) && (tile.col < (dim_.width - border_));
+    }
+
+    bool IsTarget(const Tile& tile) const {
+        return std::find(targets_.begin(), targets_.end(), tile) !=
+               targets_.end();
+    }
+
+    int GetOwner(const Tile& tile) const {
+        for (std::size_t i = 0; IsInBounds(tile) && (i < snakes_.size());
+             ++i) {
+            if (std::find(snakes_[i].begin(), snakes_[i].end(), tile) !=
+                snakes_[i].end()) {
+                return static_cast<int>(i);
+            }
+        }
+        return MultiSnakeGame::kNoSnake;
+    }
+
+    ScreenDimension dim_;
+    int border_;
+    std::size_t num_targets_;
+    std::vector<std::vector<Tile>> snakes_;
+    std::vector<bool> alive_;
+    std::vector<int> scores_;
+    std::vector<Tile> targets_;
+};
+
+/**
+ * Play seeded games in both implementations, each snake chasing a target,
+ * and check that every tick has the same outcome.
+ */
+static void TestBoard(const ScreenDimension& dim, int border,
+                      std::size_t num_snakes, std::size_t num_targets,
+                      int num_games, RuleCounts& counts) {
+    MultiSnakeGame game(dim, num_snakes, num_targets, border, Rng(0));
+    std::vector<Direction> directions(num_snakes);
+    for (int i = 0; i < num_games; ++i) {
+        const std::uint64_t kSeed = SplitMix64(static_cast<std::uint64_t>(i));
+        game.Reset(kSeed);
+        ReferenceGame reference(game, num_targets);
+        Rng rng(kSeed);
+        while (!game.GameOver() && (game.GetTicks() < 2000)) {
+            const std::vector<Tile>& targets = game.GetTargets();
+            for (std::size_t j = 0; j < num_snakes; ++j) {
+                directions[j] = Direction::kNone;
+                if (game.IsAlive(j) && !targets.empty()) {
+                    directions[j] = snake::test::ChooseDirection(
+                        game.GetSnake(j).front(), targets[j % targets.size()],
+                        rng);
+                }
+            }
+            game.Tick(directions.data());
+            reference.Tick(directions.data(), counts);
+            reference.Check(game);
+        }
+    }
+}
+
+int main() {
+    RuleCounts counts;
+    TestBoard({.width = 5, .height = 5}, 0, 4, 1, 300, counts);
+    TestBoard({.width = 8, .height = 6}, 1, 6, 2, 300, counts);
+    TestBoard({.width = 12, .height = 10}, 2, 8, 3, 200, counts);
+    TestBoard({.width = 24, .height = 16}, 1, 24, 6, 30, counts);
+    std::printf(
+        "%lld ticks, %lld head-on claims, %lld tails kept, %lld tails freed, "
+        "%lld swaps, %lld targets eaten, %lld deaths\n",
+        static_cast<long long>(counts.ticks),
+        static_cast<long long>(counts.head_on),
+        static_cast<long long>(counts.kept_tail),
+        static_cast<long long>(counts.freed_tail),
+        static_cast<long long>(counts.swaps),
+        static_cast<long long>(counts.eaten),
+        static_cast<long long>(counts.deaths));
+
+    /* every rule the tick resolves came up */
+    CHECK(counts.head_on > 0);
+    CHECK(counts.kept_tail > 0);
+    CHECK(counts.freed_tail > 0);
+    CHECK(counts.swaps > 0);
+    return 0;
+}
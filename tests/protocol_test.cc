@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "net/protocol.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+using snake::game::SplitMix64;
+using snake::net::SpectatorView;
+
+/** Check that the view shows the game, Tile for Tile. */
+static void CheckSameGame(const SpectatorView& view, const SnakeGame& game) {
+    CHECK(view.HasGame());
+    CHECK(view.GetScreenDimension().width == game.GetScreenDimension().width);
+    CHECK(view.GetScreenDimension().height ==
+          game.GetScreenDimension().height);
+    CHECK(view.GetBorder() == game.GetBorder());
+    CHECK(view.GetScore() == game.GetScore());
+    CHECK(view.GetTicks() == game.GetTicks());
+    CHECK(view.GameOver() == game.GameOver());
+    CHECK(view.GetTargetTile() == game.GetTargetTile());
+    CHECK(view.GetSnake().size() == game.GetSnake().size());
+    for (std::size_t i = 0; i < game.GetSnake().size(); ++i) {
+        CHECK(view.GetSnake()[i] == game.GetSnake()[i]);
+        CHECK(view.GetSnake()[i].direction == game.GetSnake()[i].direction);
+    }
+}
+
+/**
+ * Feed the bytes to the view in chunks of random sizes.
+ *
+ * @returns false if the view found the stream malformed.
+ */
+static bool FeedSplit(SpectatorView& view,
+                      const std::vector<std::uint8_t>& bytes, Rng& rng) {
+    std::size_t pos = 0;
+    while (pos < bytes.size()) {
+        const std::size_t kLeft = bytes.size() - pos;
+        const std::size_t kLen =
+            (rng.Below(4) == 0)
+                ? kLeft
+                : (1 + rng.Below(static_cast<std::uint32_t>(
+                           std::min<std::size_t>(kLeft, 8))));
+        if (!view.Feed(bytes.data() + pos, kLen)) {
+            return false;
+        }
+        pos += kLen;
+    }
+    return true;
+}
+
+/**
+ * Stream seeded games to a single view the way SpectatorServer does, a
+ * snapshot at the start of every game and after every resize and a delta
+ * per tick, and check the view after each batch of frames fed to it.
+ */
+static void TestStream(const ScreenDimension& dim, int num_games) {
+    SnakeGame game(dim, 1, Rng(0));
+    SpectatorView view;
+    std::vector<std::uint8_t> stream;
+    std::int64_t num_checks = 0;
+    for (int i = 0; i < num_games; ++i) {
+        const std::uint64_t kSeed = SplitMix64(static_cast<std::uint64_t>(i));
+        Rng rng(kSeed);
+        game.Reset(kSeed);
+        snake::net::EncodeSnapshot(game, stream);
+        while (!game.GameOver() && (game.GetTicks() < 5000)) {
+            /* an occasional blunder ends the games on larger boards */
+            game.Tick((rng.Below(64) == 0)
+                          ? snake::test::ChooseDirection(
+                                game.GetSnake()[0], game.GetTargetTile(), rng)
+                          : snake::test::ChooseSafeDirection(game, rng));
+            snake::net::EncodeDelta(game, stream);
+
+            /* a resize shifts the snake, which only a snapshot describes */
+            if (!game.GameOver() && (rng.Below(256) == 0)) {
+                const ScreenDimension kMinDim = game.GetMinScreenDimension();
+                const ScreenDimension kDim = {
+                    .width = kMinDim.width +
+                             static_cast<int>(rng.Below(
+                                 static_cast<std::uint32_t>(dim.width))),
+                    .height = kMinDim.height +
+                              static_cast<int>(rng.Below(
+                                  static_cast<std::uint32_t>(dim.height)))};
+                CHECK(game.Resize(kDim));
+                snake::net::EncodeSnapshot(game, stream);
+            }
+
+            /* frames pile up while a spectator lags behind */
+            if (rng.Below(4) == 0) {
+                CHECK(FeedSplit(view, stream, rng));
+                stream.clear();
+                CheckSameGame(view, game);
+                num_checks++;
+            }
+        }
+        CHECK(FeedSplit(view, stream, rng));
+        stream.clear();
+        CheckSameGame(view, game);
+        num_checks++;
+    }
+    std::printf("%dx%d: %d games, %lld frames, %lld snapshots, %lld checks\n",
+                dim.width, dim.height, num_games,
+                static_cast<long long>(view.GetNumFrames()),
+                static_cast<long long>(view.GetNumSnapshots()),
+                static_cast<long long>(num_checks));
+}
+
+static void PutVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * Check that a snapshot of a one Tile snake on the largest board allowed
+ * leaves the view's storage sized by the snake rather than by the board,
+ * and that deltas growing the snake grow it in step.
+ */
+static void TestLargeBoard() {
+    const int kSide = snake::game::kMaxPackedCoordinate;
+    std::vector<std::uint8_t> stream;
+
+    /* tag, ticks, width, height, border, score, game over, target row and
+     * column, length, head row and column and the head's direction, see
+     * EncodeSnapshot(), coordinates being zigzag encoded */
+    stream.push_back(0x80);
+    for (const std::uint64_t kValue :
+         {0, kSide, kSide, 1, 0, 0, 2 * 1, 2 * 1, 1, 2 * 2, 2 * 2}) {
+        PutVarint(stream, kValue);
+    }
+    stream.push_back(static_cast<std::uint8_t>(Direction::kRight));
+
+    SpectatorView view;
+    CHECK(view.Feed(stream.data(), stream.size()));
+    CHECK(view.HasGame() && (1 == view.GetSnake().size()));
+    CHECK(view.GetSnake().capacity() <= 16);
+
+    /* deltas moving right which each grew the snake, adding the score */
+    const int kNumDeltas = 1000;
+    for (int i = 1; i <= kNumDeltas; ++i) {
+        stream.clear();
+        stream.push_back(static_cast<std::uint8_t>(Direction::kRight) | 0x08);
+        PutVarint(stream, static_cast<std::uint64_t>(10 * i));
+        CHECK(view.Feed(stream.data(), stream.size()));
+    }
+    CHECK(static_cast<std::size_t>(kNumDeltas + 1) == view.GetSnake().size());
+    CHECK(view.GetSnake().capacity() <= 2 * view.GetSnake().size());
+    CHECK(view.GetSnake().front().col == 2 + kNumDeltas);
+}
+
+/**
+ * Feed random bytes and corrupted streams in random splits and check the
+ * view rejects what it cannot decode without crashing.
+ */
+static void TestRandomInput() {
+    Rng rng(1);
+    SnakeGame game({.width = 12, .height = 9}, 1, Rng(0));
+    std::vector<std::uint8_t> bytes;
+    std::int64_t num_rejected = 0;
+    const int kNumStreams = 20000;
+    for (int i = 0; i < kNumStreams; ++i) {
+        bytes.clear();
+        const std::uint32_t kKind = rng.Below(3);
+        if (kKind < 2) {
+            /* a frame starts with a snapshot tag or a delta byte, and a
+             * delta before any snapshot is malformed too, so random bytes
+             * not starting on a snapshot tag are always rejected */
+            const std::size_t kLen = 1 + rng.Below(64);
+            for (std::size_t j = 0; j < kLen; ++j) {
+                bytes.push_back(static_cast<std::uint8_t>(rng.Below(256)));
+            }
+            if (1 == kKind) {
+                bytes[0] = 0x80;
+            }
+        } else {
+            /* a real stream with a few bytes overwritten */
+            game.Reset(rng());
+            snake::net::EncodeSnapshot(game, bytes);
+            for (int tick = 0; (tick < 50) && !game.GameOver(); ++tick) {
+                game.Tick(snake::test::ChooseSafeDirection(game, rng));
+                snake::net::EncodeDelta(game, bytes);
+            }
+            for (std::uint32_t j = 1 + rng.Below(4); j > 0; --j) {
+                bytes[rng.Below(static_cast<std::uint32_t>(bytes.size()))] =
+                    static_cast<std::uint8_t>(rng.Below(256));
+            }
+        }
+
+        SpectatorView view;
+        const bool kAccepted = FeedSplit(view, bytes, rng);
+        if ((0 == kKind) && (0x80 != bytes[0])) {
+            CHECK(!kAccepted);
+        }
+        num_rejected += kAccepted ? 0 : 1;
+    }
+    std::printf("%d random streams, %lld rejected\n", kNumStreams,
+                static_cast<long long>(num_rejected));
+    CHECK(num_rejected > 0);
+}
+
+int main() {
+    TestStream({.width = 6, .height = 5}, 200);
+    TestStream({.width = 20, .height = 12}, 100);
+    TestStream({.width = 80, .height = 24}, 20);
+    TestLargeBoard();
+    TestRandomInput();
+    return 0;
+}
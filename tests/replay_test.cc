@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+#include "replay/player.hpp"
+#include "replay/replay.hpp"
+#include "sim/autopilot.hpp"
+#include "test_util.hpp"
+
+using snake::game::Direction;
+using snake::game::GameState;
+using snake::game::Rng;
+using snake::game::ScreenDimension;
+using snake::game::SnakeGame;
+using snake::replay::Replay;
+using snake::replay::ReplayPlayer;
+
+/** State of the recorded game after each tick, as seen from outside. */
+struct Recorded {
+    GameState state;
+    ScreenDimension dim;
+};
+
+/**
+ * Record a game of num_ticks ticks played by the autopilot, which keeps the
+ * snake alive for long, resizing the board a few times early on, and keep
+ * its state after every tick.
+ */
+static Replay RecordGame(std::uint64_t seed, std::int64_t num_ticks,
+                         std::vector<Recorded>& recorded) {
+    const ScreenDimension kDims[] = {{.width = 40, .height = 20},
+                                     {.width = 44, .height = 18},
+                                     {.width = 36, .height = 24}};
+    Replay replay;
+    replay.seed = seed;
+    replay.dim = kDims[0];
+    replay.border = 1;
+
+    SnakeGame game(replay.dim, replay.border, Rng(seed));
+    snake::sim::AutopilotController autopilot;
+    autopilot.NewGame(game, seed);
+    recorded.resize(static_cast<std::size_t>(num_ticks) + 1);
+    game.SaveState(recorded[0].state);
+    recorded[0].dim = game.GetScreenDimension();
+    for (std::int64_t tick = 1; tick <= num_ticks; ++tick) {
+        const Direction kDirection = autopilot.NextDirection(game);
+        game.Tick(kDirection);
+        replay.Append(kDirection);
+        if ((0 == (tick % 97)) && (tick < 500) &&
+            game.Resize(kDims[(tick / 97) % std::size(kDims)])) {
+            replay.AppendResize(game.GetScreenDimension());
+        }
+
+        Recorded& entry = recorded[static_cast<std::size_t>(tick)];
+        game.SaveState(entry.state);
+        entry.dim = game.GetScreenDimension();
+    }
+    return replay;
+}
+
+/** Check that the player's game is the recorded game at its tick. */
+static void CheckSeek(const ReplayPlayer& player,
+                      const std::vector<Recorded>& recorded) {
+    const Recorded& kEntry = recorded[static_cast<std::size_t>(
+        player.GetTick())];
+    const SnakeGame& kGame = player.GetGame();
+    CHECK(kGame.GetScreenDimension().width == kEntry.dim.width);
+    CHECK(kGame.GetScreenDimension().height == kEntry.dim.height);
+    CHECK(kGame.GetTicks() == kEntry.state.ticks);
+    CHECK(kGame.GetScore() == kEntry.state.score);
+    CHECK(kGame.GameOver() == kEntry.state.game_over);
+    CHECK(kGame.GetTargetTile() == kEntry.state.target);
+    CHECK(kGame.GetSnake().size() == kEntry.state.snake.size());
+    for (std::size_t i = 0; i < kEntry.state.snake.size(); ++i) {
+        CHECK(kGame.GetSnake()[i] == kEntry.state.snake[i]);
+    }
+}
+
+/**
+ * Seek back and forth through a long replay with a short checkpoint
+ * interval, which thins the checkpoints many times over, and check every
+ * seek lands exactly on the recorded game.
+ */
+static void TestSeek(std::uint64_t seed) {
+    const std::int64_t kNumTicks = 5000;
+    std::vector<Recorded> recorded;
+    const Replay kReplay = RecordGame(seed, kNumTicks, recorded);
+
+    ReplayPlayer player(kReplay, 4);
+    CHECK(kNumTicks == player.NumTicks());
+    Rng rng(seed);
+    for (int i = 0; i < 400; ++i) {
+        /* alternate long random jumps with short steps either way */
+        std::int64_t tick = 0;
+        if (i % 2) {
+            tick = static_cast<std::int64_t>(
+                rng.Below(static_cast<std::uint32_t>(kNumTicks + 1)));
+        } else {
+            tick = player.GetTick() + static_cast<std::int64_t>(rng.Below(21)) -
+                   10;
+        }
+        player.Seek(tick);
+        CHECK(player.GetTick() == std::clamp<std::int64_t>(tick, 0, kNumTicks));
+        CHECK(player.NumCheckpoints() <= ReplayPlayer::kMaxCheckpoints);
+        CheckSeek(player, recorded);
+    }
+    player.Seek(kNumTicks);
+    CheckSeek(player, recorded);
+    std::printf("seed %llu: score %d, %zu checkpoints every %lld ticks\n",
+                static_cast<unsigned long long>(seed),
+                player.GetGame().GetScore(), player.NumCheckpoints(),
+                static_cast<long long>(player.GetCheckpointInterval()));
+}
+
+int main() {
+    for (std::uint64_t seed = 0; seed < 4; ++seed) {
+        TestSeek(seed);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "game/rng.hpp"
+#include "scores/score_store.hpp"
+#include "test_util.hpp"
+
+using snake::game::Rng;
+using snake::scores::GameRecord;
+using snake::scores::ScoreKey;
+using snake::scores::ScoreStore;
+
+/* modes and boards the records are spread over */
+static const int kNumModes = 3;
+static const int kBoards[][2] = {{80, 24}, {120, 40}, {20, 10}};
+
+/** Check that the indexed best score of every key matches a full scan. */
+static void CheckBestScores(const ScoreStore& store) {
+    for (int mode = 0; mode < kNumModes; ++mode) {
+        for (const auto& board : kBoards) {
+            const ScoreKey kKey = {
+                .mode = mode, .width = board[0], .height = board[1]};
+            const std::vector<GameRecord> kBest = store.GetHighScores(kKey, 1);
+            int score = -1;
+            CHECK(store.GetBestScore(kKey, score) == !kBest.empty());
+            CHECK(kBest.empty() || (score == kBest[0].score));
+        }
+    }
+}
+
+static GameRecord RandomRecord(Rng& rng) {
+    const auto& board = kBoards[rng.Below(std::size(kBoards))];
+    GameRecord record;
+    record.score = static_cast<std::int32_t>(rng.Below(1000));
+    record.width = static_cast<std::uint16_t>(board[0]);
+    record.height = static_cast<std::uint16_t>(board[1]);
+    record.mode = static_cast<std::uint8_t>(rng.Below(kNumModes));
+    record.flags = (rng.Below(4) == 0) ? snake::scores::kAutopilotFlag : 0;
+    return record;
+}
+
+/**
+ * Append records through two stores sharing a file, the second standing in
+ * for another process, and check the best scores after every append.
+ */
+static void TestBestScores(const std::string& path) {
+    ScoreStore store;
+    ScoreStore other;
+    CHECK(store.Open(path) && other.Open(path));
+    CheckBestScores(store);
+
+    Rng rng(7);
+    for (int i = 0; i < 3000; ++i) {
+        CHECK(other.Append(RandomRecord(rng)));
+        if (i % 3) {
+            continue;
+        }
+        CHECK(store.Append(RandomRecord(rng)));
+        CheckBestScores(store);
+        CheckBestScores(other);
+    }
+
+    /* a reopened store indexes the file from the start */
+    CHECK(store.Open(path));
+    CheckBestScores(store);
+}
+
+int main() {
+    char path[] = "/tmp/snake_score_test_XXXXXX";
+    const int kFd = mkstemp(path);
+    CHECK(kFd >= 0);
+    close(kFd);
+    unlink(path);
+
+    TestBestScores(path);
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_UTIL_HPP_
+#define TEST_UTIL_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "game/game.hpp"
+#include "game/rng.hpp"
+#include "game/tile.hpp"
+
+/** Exit the test with the failed condition and its location unless the
+ * condition holds. */
+#define CHECK(condition)                                                  \
+    do {                                                                  \
+        if (!(condition)) {                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,   \
+                         __LINE__, #condition);                           \
+            std::exit(1);                                                 \
+        }                                                                 \
+    } while (0)
+
+namespace snake {
+namespace test {
+
+/**
+ * Return the next direction of a snake chasing the target.
+ *
+ * Most moves head for the target so the snake grows and games run long, the
+ * rest are random and include Direction::kNone and turning back onto the
+ * body so every kind of tick gets played.
+ */
+inline game::Direction ChooseDirection(const game::Tile& head,
+                                       const game::Tile& target,
+                                       game::Rng& rng) {
+    if (rng.Below(4) == 0) {
+        return static_cast<game::Direction>(rng.Below(5));
+    }
+    if (target.row != head.row) {
+        return (target.row < head.row) ? game::Direction::kUp
+                                       : game::Direction::kDown;
+    }
+    return (target.col < head.col) ? game::Direction::kLeft
+                                   : game::Direction::kRight;
+}
+
+/**
+ * Return the next direction of a snake chasing its target which steers clear
+ * of moves that end the game where it can, so the snake grows long.
+ */
+inline game::Direction ChooseSafeDirection(const game::SnakeGame& game,
+                                           game::Rng& rng) {
+    const game::Tile kHead = game.GetSnake()[0];
+    game::Direction direction =
+        ChooseDirection(kHead, game.GetTargetTile(), rng);
+    for (int i = 0;
+         (i < 4) && !game.IsFree(game::Neighbor(kHead, direction)); ++i) {
+        direction = static_cast<game::Direction>(
+            (static_cast<int>(direction) + 1) % 4);
+    }
+    return direction;
+}
+
+}  // namespace test
+}  // namespace snake
+
+#endif